@@ -1,7 +1,11 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Component/PRMovementComponent.h"
+#include "Components/CapsuleComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "Component/WeaponComponent.h"
+#include "Framework/PRCharacter.h"
+#include "Misc/RootMotionSource_Leap.h"
 
 UPRMovementComponent::UPRMovementComponent()
 	: Super()
@@ -19,6 +23,15 @@ UPRMovementComponent::UPRMovementComponent()
 	RunSpeed = 600.0f;
 	WalkSpeed = 400.0f;
 	LockSpeed = 300.0f;
+
+	LeapSourceId = 0u;
+	LeapPathKey = 0u;
+	LockRotationSpeed = 10.0f;
+
+	ReducedTickInterval = 1.0f / 15.0f;
+	MinimalTickInterval = 0.25f;
+	MovementLOD = EMovementLOD::Full;
+	SavedPawnResponse = ECR_Block;
 }
 
 void UPRMovementComponent::SetRunSpeed(float InRunSpeed)
@@ -38,8 +51,11 @@ void UPRMovementComponent::SetLockSpeed(float InLockSpeed)
 
 void UPRMovementComponent::SetMoveState(EMoveState NewMoveState)
 {
-	if (MoveState != NewMoveState)
-		ServerSetMoveState(NewMoveState);
+	// Applied right away; a remote owner's state reaches the server with its saved moves.
+	if (MoveState == NewMoveState) return;
+
+	MoveState = NewMoveState;
+	OnRep_MoveState();
 }
 
 void UPRMovementComponent::ApplyLock(bool bIsLock)
@@ -48,6 +64,70 @@ void UPRMovementComponent::ApplyLock(bool bIsLock)
 	SetMovement();
 }
 
+void UPRMovementComponent::SetMovementLOD(EMovementLOD NewLOD)
+{
+	if (MovementLOD == NewLOD) return;
+
+	const bool bWasMinimal = MovementLOD == EMovementLOD::Minimal;
+	MovementLOD = NewLOD;
+
+	const bool bIsFull = NewLOD == EMovementLOD::Full;
+	const bool bIsMinimal = NewLOD == EMovementLOD::Minimal;
+
+	SetComponentTickInterval(bIsFull ? 0.0f : bIsMinimal ? MinimalTickInterval : ReducedTickInterval);
+
+	// Lower tiers walk on the navmesh instead of sweeping for the floor, the lowest one without sweeps at all.
+	bProjectNavMeshWalking = !bIsFull;
+	bSweepWhileNavWalking = !bIsMinimal;
+
+	if (bIsFull && MovementMode == MOVE_NavWalking)
+		SetMovementMode(DefaultLandMovementMode);
+	else if (!bIsFull && MovementMode == MOVE_Walking)
+		SetMovementMode(MOVE_NavWalking);
+
+	if (!CharacterOwner || bIsMinimal == bWasMinimal)
+		return;
+
+	// Pawn collision is handed back as it was configured, not as a hard block.
+	UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	if (bIsMinimal)
+	{
+		SavedPawnResponse = Capsule->GetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn);
+		Capsule->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECR_Ignore);
+	}
+	else
+	{
+		Capsule->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, SavedPawnResponse);
+	}
+}
+
+void UPRMovementComponent::StartLeap(const TArray<FVector>& Points, float Duration, float FirstRatio)
+{
+	StopLeap();
+
+	TSharedPtr<FRootMotionSource_Leap> Source = MakeShared<FRootMotionSource_Leap>();
+	Source->InstanceName = TEXT("Leap");
+	Source->Duration = Duration;
+	Source->SetPath(Points, FirstRatio);
+
+	SetMovementMode(MOVE_Flying);
+	LeapSourceId = ApplyRootMotionSource(Source);
+
+	if (GetOwnerRole() == ROLE_Authority)
+		MulticastStartLeap(TArray<FVector_NetQuantize10>{ Points }, Duration, FirstRatio);
+}
+
+void UPRMovementComponent::StopLeap()
+{
+	if (LeapSourceId == 0u) return;
+
+	RemoveRootMotionSourceByID(LeapSourceId);
+	LeapSourceId = 0u;
+
+	if (MovementMode == MOVE_Flying)
+		SetMovementMode(MOVE_Falling);
+}
+
 void UPRMovementComponent::BeginPlay()
 {
 	Super::BeginPlay();
@@ -62,7 +142,7 @@ void UPRMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME(UPRMovementComponent, RunSpeed);
 	DOREPLIFETIME(UPRMovementComponent, WalkSpeed);
 	DOREPLIFETIME(UPRMovementComponent, LockSpeed);
-	DOREPLIFETIME(UPRMovementComponent, MoveState);
+	DOREPLIFETIME_CONDITION(UPRMovementComponent, MoveState, COND_SkipOwner);
 }
 
 void UPRMovementComponent::AddInputVector(FVector WorldVector, bool bForce)
@@ -77,14 +157,103 @@ FVector UPRMovementComponent::ConsumeInputVector()
 	{
 		LastInputVector = InputVector;
 		InputVector = FVector::ZeroVector;
-	
-		if (GetOwnerRole() == ROLE_AutonomousProxy)
-			ServerSetLastInputVector(LastInputVector);
 	}
 
 	return Super::ConsumeInputVector();
 }
 
+void UPRMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	// A finished leap falls back to the ground by itself on the server and the owner.
+	if (LeapSourceId != 0u && !GetRootMotionSourceByID(LeapSourceId).IsValid())
+	{
+		LeapSourceId = 0u;
+		if (MovementMode == MOVE_Flying)
+			SetMovementMode(MOVE_Falling);
+	}
+}
+
+void UPRMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	// The lock travels with the client's moves, so the server changes speed on the same move.
+	const bool bIsLock = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	if (bIsLock != static_cast<bool>(bIsLocked))
+		ApplyLock(bIsLock);
+
+	const EMoveState NewMoveState = (Flags & FSavedMove_Character::FLAG_Custom_1) ? EMoveState::Run : EMoveState::Walk;
+	if (NewMoveState != MoveState)
+	{
+		MoveState = NewMoveState;
+		OnRep_MoveState();
+	}
+}
+
+void UPRMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+
+	// A remote owner's input direction is recovered from the acceleration of the move just simulated.
+	LastInputVector = Acceleration.GetSafeNormal2D();
+}
+
+bool UPRMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	// Replayed moves apply their own lock and move state, which must not undo a toggle made after the last of them.
+	const EMoveState CurrentMoveState = MoveState;
+	const bool bWasLocked = bIsLocked;
+
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	if (MoveState != CurrentMoveState || bIsLocked != bWasLocked)
+	{
+		MoveState = CurrentMoveState;
+		bIsLocked = bWasLocked;
+		SetMovement();
+	}
+
+	return bResult;
+}
+
+FNetworkPredictionData_Client* UPRMovementComponent::GetPredictionData_Client() const
+{
+	if (!ClientPredictionData)
+	{
+		auto* MutableThis = const_cast<UPRMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_PR{ *this };
+	}
+
+	return ClientPredictionData;
+}
+
+void UPRMovementComponent::PhysicsRotation(float DeltaTime)
+{
+	const AActor* Target = LockTarget.Get();
+	const auto* Character = Cast<APRCharacter>(CharacterOwner);
+
+	// Facing stays inside the movement update, so it is predicted and replicated like any other rotation.
+	const bool bCanFace = Character && (!Character->IsMoveInputIgnored()
+		|| Character->GetWeaponComponent()->IsCheckingCombo());
+
+	if (!Target || !bCanFace || !UpdatedComponent)
+	{
+		Super::PhysicsRotation(DeltaTime);
+		return;
+	}
+
+	const FRotator CurrentRotation = UpdatedComponent->GetComponentRotation();
+	const FVector Direction = Target->GetActorLocation() - UpdatedComponent->GetComponentLocation();
+
+	const FRotator DesiredRotation{ 0.0f, Direction.Rotation().Yaw, 0.0f };
+	const FRotator NewRotation = FMath::RInterpTo(CurrentRotation, DesiredRotation, DeltaTime, LockRotationSpeed);
+
+	if (!NewRotation.Equals(CurrentRotation))
+		MoveUpdatedComponent(FVector::ZeroVector, NewRotation, false);
+}
+
 void UPRMovementComponent::ServerSetRunSpeed_Implementation(float InRunSpeed)
 {
 	RunSpeed = InRunSpeed;
@@ -103,10 +272,23 @@ void UPRMovementComponent::ServerSetLockSpeed_Implementation(float InLockSpeed)
 	OnRep_LockSpeed();
 }
 
-void UPRMovementComponent::ServerSetMoveState_Implementation(EMoveState NewMoveState)
+void UPRMovementComponent::MulticastStartLeap_Implementation(const TArray<FVector_NetQuantize10>& Points, float Duration, float FirstRatio)
 {
-	MoveState = NewMoveState;
-	OnRep_MoveState();
+	if (GetOwnerRole() == ROLE_Authority)
+		return;
+
+	LeapPoints = TArray<FVector>{ Points };
+	LeapPathKey = FRootMotionSource_Leap::MakePathKey(LeapPoints);
+
+	if (GetOwnerRole() != ROLE_AutonomousProxy)
+		return;
+
+	// The server's path wins; the predicted source keeps its ID and time and only changes course.
+	const TSharedPtr<FRootMotionSource> Source = LeapSourceId != 0u ? GetRootMotionSourceByID(LeapSourceId) : nullptr;
+	if (Source.IsValid())
+		static_cast<FRootMotionSource_Leap*>(Source.Get())->SetPath(LeapPoints, FirstRatio);
+	else
+		StartLeap(LeapPoints, Duration, FirstRatio);
 }
 
 void UPRMovementComponent::OnRep_RunSpeed()
@@ -148,3 +330,61 @@ void UPRMovementComponent::SetMovement()
 		bUseControllerDesiredRotation = bOrientRotationToMovement = false;
 	}
 }
+
+void FSavedMove_PR::Clear()
+{
+	Super::Clear();
+	bSavedIsLocked = false;
+	bSavedIsRunning = false;
+}
+
+uint8 FSavedMove_PR::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+	if (bSavedIsLocked) Result |= FLAG_Custom_0;
+	if (bSavedIsRunning) Result |= FLAG_Custom_1;
+	return Result;
+}
+
+bool FSavedMove_PR::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const auto* Other = static_cast<FSavedMove_PR*>(NewMove.Get());
+	if (bSavedIsLocked != Other->bSavedIsLocked || bSavedIsRunning != Other->bSavedIsRunning)
+		return false;
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_PR::SetMoveFor(ACharacter* InCharacter, float InDeltaTime,
+	FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(InCharacter, InDeltaTime, NewAccel, ClientData);
+
+	const auto* Movement = Cast<UPRMovementComponent>(InCharacter->GetCharacterMovement());
+	bSavedIsLocked = Movement && Movement->IsLockApplied();
+	bSavedIsRunning = Movement && Movement->GetMoveState() == EMoveState::Run;
+}
+
+void FSavedMove_PR::PrepMoveFor(ACharacter* InCharacter)
+{
+	Super::PrepMoveFor(InCharacter);
+
+	// Replayed moves run with the lock and move state they were first made with.
+	auto* Movement = Cast<UPRMovementComponent>(InCharacter->GetCharacterMovement());
+	if (!Movement) return;
+
+	if (Movement->IsLockApplied() != static_cast<bool>(bSavedIsLocked))
+		Movement->ApplyLock(bSavedIsLocked);
+
+	Movement->SetMoveState(bSavedIsRunning ? EMoveState::Run : EMoveState::Walk);
+}
+
+FNetworkPredictionData_Client_PR::FNetworkPredictionData_Client_PR(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_PR::AllocateNewMove()
+{
+	return FSavedMovePtr{ new FSavedMove_PR{} };
+}
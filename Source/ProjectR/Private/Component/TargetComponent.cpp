@@ -1,25 +1,88 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Component/TargetComponent.h"
-#include "Kismet/KismetMathLibrary.h"
+#include "GameFramework/Controller.h"
 #include "Net/UnrealNetwork.h"
-#include "Perception/AIPerceptionComponent.h"
 #include "Framework/PRCharacter.h"
+#include "Subsystem/LockOnSubsystem.h"
+#include "Subsystem/TargetingSubsystem.h"
 
 UTargetComponent::UTargetComponent()
 	: Super()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SightRadius = 3000.0f;
+	SightAngle = 90.0f;
+	AngleWeight = 1.0f;
+	DistanceWeight = 0.25f;
+	ThreatWeight = 0.5f;
+	DistanceScale = 1000.0f;
+	RescoreAngle = 5.0f;
+	ScoredYaw = 0.0f;
+	NextUpdateTime = 0.0f;
+	bIsDirty = false;
 }
 
-void UTargetComponent::Initialize(UAIPerceptionComponent* Perception)
+void UTargetComponent::SetInterval(float InInterval)
 {
-	Perception->OnTargetPerceptionUpdated.AddDynamic(this, &UTargetComponent::OnPerceptionUpdated);
+	ServerSetInterval(InInterval);
 }
 
-void UTargetComponent::SetInterval(float InInterval)
+void UTargetComponent::UpdateCandidates(const TArray<AActor*>& Candidates, float Now)
 {
-	ServerSetInterval(InInterval);
+	NextUpdateTime = Now + Interval;
+
+	if (TargetActors != Candidates)
+	{
+		TargetActors = Candidates;
+		bIsDirty = true;
+	}
+
+	FVector Loc;
+	FRotator Rot;
+	GetView(Loc, Rot);
+
+	// Scores only change meaningfully with new candidates or a turned view.
+	const bool bIsTurned = FMath::Abs(FMath::FindDeltaAngleDegrees(ScoredYaw, Rot.Yaw)) > RescoreAngle;
+	if (bIsDirty || bIsTurned || !IsValid(TargetedActor))
+		ScoreTargets(Loc, Rot);
+
+	// A locked target that left sight is handed back to the lock-on subsystem.
+	const auto* Controller = Cast<AController>(GetOwner());
+	auto* MyPawn = Controller ? Controller->GetPawn<APRCharacter>() : nullptr;
+
+	AActor* LockedTarget = MyPawn ? MyPawn->GetLockedTarget() : nullptr;
+	if (LockedTarget && !TargetActors.Contains(LockedTarget))
+		if (auto* LockOn = ULockOnSubsystem::Get(this))
+			LockOn->NotifyTargetLost(MyPawn, LockedTarget);
+}
+
+void UTargetComponent::UpdateView()
+{
+	if (TargetActors.Num() == 0)
+		return;
+
+	FVector Loc;
+	FRotator Rot;
+	GetView(Loc, Rot);
+
+	if (FMath::Abs(FMath::FindDeltaAngleDegrees(ScoredYaw, Rot.Yaw)) > RescoreAngle)
+		ScoreTargets(Loc, Rot);
+}
+
+void UTargetComponent::RemoveCandidate(AActor* Candidate)
+{
+	if (TargetActors.RemoveSingleSwap(Candidate, false) == 0 && TargetedActor != Candidate)
+		return;
+
+	if (TargetedActor == Candidate)
+		TargetedActor = nullptr;
+
+	FVector Loc;
+	FRotator Rot;
+	GetView(Loc, Rot);
+	ScoreTargets(Loc, Rot);
 }
 
 void UTargetComponent::BeginPlay()
@@ -27,19 +90,45 @@ void UTargetComponent::BeginPlay()
 	Super::BeginPlay();
 
 	if (GetOwnerRole() == ENetRole::ROLE_Authority)
-		SetComponentTickInterval(Interval);
-	else
-		SetComponentTickEnabled(false);
+		if (auto* Targeting = UTargetingSubsystem::Get(this))
+			Targeting->RegisterViewer(this);
 }
 
-void UTargetComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UTargetComponent::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (auto* Targeting = UTargetingSubsystem::Get(this))
+		Targeting->UnregisterViewer(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTargetComponent::GetView(FVector& OutLocation, FRotator& OutRotation) const
+{
+	const AActor* MyOwner = GetOwner();
+	OutLocation = MyOwner->GetActorLocation();
+	OutRotation = MyOwner->GetActorRotation();
+
+	if (const auto* Controller = Cast<AController>(MyOwner))
+	{
+		if (const APawn* Pawn = Controller->GetPawn())
+			OutLocation = Pawn->GetActorLocation();
+
+		OutRotation = Controller->GetControlRotation();
+	}
+	else if (const auto* Pawn = Cast<APawn>(MyOwner))
+	{
+		if (Pawn->IsPawnControlled())
+			OutRotation = Pawn->GetControlRotation();
+	}
+}
+
+void UTargetComponent::ScoreTargets(const FVector& Location, const FRotator& Rotation)
+{
+	bIsDirty = false;
+	ScoredYaw = Rotation.Yaw;
+
+	TargetActors.RemoveAllSwap([](const AActor* Actor) { return !IsValid(Actor); }, false);
 
-	if (GetOwnerRole() != ENetRole::ROLE_Authority)
-		return;
-	
-	TargetActors.Remove(nullptr);
 	const int32 Num = TargetActors.Num();
 	if (Num == 0)
 	{
@@ -47,29 +136,62 @@ void UTargetComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 		return;
 	}
 
-	auto* MyOwner = GetOwner();
-	const FVector Loc = MyOwner->GetActorLocation();
-	FRotator Rot = MyOwner->GetActorRotation();
+	const int32 LaneNum = Align(Num, 4);
+	CandidateX.SetNumUninitialized(LaneNum, false);
+	CandidateY.SetNumUninitialized(LaneNum, false);
+	Threats.SetNumUninitialized(LaneNum, false);
+	Scores.SetNumUninitialized(LaneNum, false);
 
-	if (auto* Pawn = Cast<APawn>(MyOwner))
-		if (Pawn->IsPawnControlled())
-			Rot = Pawn->GetControlRotation();
-	
-	TArray<float> RotationArray;
-	RotationArray.Init(0.0f, Num);
+	const AActor* Viewer = GetOwner();
+	if (const auto* Controller = Cast<AController>(Viewer))
+		Viewer = Controller->GetPawn();
 
-	int32 MinIdx = 0;
+	for (int32 Idx = 0; Idx < LaneNum; ++Idx)
+	{
+		// Padding lanes sit one unit ahead of the viewer and are never picked.
+		const AActor* Actor = Idx < Num ? TargetActors[Idx] : nullptr;
+		const FVector Point = Actor ? Actor->GetActorLocation() : Location + Rotation.Vector();
+		const auto* Character = Cast<APRCharacter>(Actor);
+
+		CandidateX[Idx] = Point.X;
+		CandidateY[Idx] = Point.Y;
+		Threats[Idx] = Character && Viewer && Character->GetLockedTarget() == Viewer ? 1.0f : 0.0f;
+	}
 
-	for (int32 Idx = 0; Idx < Num; ++Idx)
+	// Angle costs 1 - cos on the horizontal plane, which is monotonic in the angle and needs no wrapping.
+	const FVector2D Forward = FVector2D{ Rotation.Vector() }.GetSafeNormal();
+	const VectorRegister FX = VectorSetFloat1(Forward.X);
+	const VectorRegister FY = VectorSetFloat1(Forward.Y);
+	const VectorRegister LX = VectorSetFloat1(Location.X);
+	const VectorRegister LY = VectorSetFloat1(Location.Y);
+	const VectorRegister Epsilon = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister AngleW = VectorSetFloat1(AngleWeight);
+	const VectorRegister DistanceW = VectorSetFloat1(DistanceScale > 0.0f ? DistanceWeight / DistanceScale : 0.0f);
+	const VectorRegister ThreatW = VectorSetFloat1(ThreatWeight);
+
+	for (int32 Idx = 0; Idx < LaneNum; Idx += 4)
 	{
-		const FRotator Look = UKismetMathLibrary
-			::FindLookAtRotation(Loc, TargetActors[Idx]->GetActorLocation());
-		
-		RotationArray[Idx] = FMath::Abs((Look - Rot).Yaw);
-		if (RotationArray[Idx] < RotationArray[MinIdx])
-			MinIdx = Idx;
+		const VectorRegister DX = VectorSubtract(VectorLoad(&CandidateX[Idx]), LX);
+		const VectorRegister DY = VectorSubtract(VectorLoad(&CandidateY[Idx]), LY);
+
+		const VectorRegister DistSq = VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, Epsilon));
+		const VectorRegister InvDist = VectorReciprocalSqrt(DistSq);
+
+		const VectorRegister Cos = VectorMultiply(VectorMultiplyAdd(DX, FX, VectorMultiply(DY, FY)), InvDist);
+		const VectorRegister Dist = VectorMultiply(DistSq, InvDist);
+
+		VectorRegister Score = VectorMultiply(VectorSubtract(VectorOne(), Cos), AngleW);
+		Score = VectorMultiplyAdd(Dist, DistanceW, Score);
+		Score = VectorSubtract(Score, VectorMultiply(VectorLoad(&Threats[Idx]), ThreatW));
+
+		VectorStore(Score, &Scores[Idx]);
 	}
 
+	int32 MinIdx = 0;
+	for (int32 Idx = 1; Idx < Num; ++Idx)
+		if (Scores[Idx] < Scores[MinIdx])
+			MinIdx = Idx;
+
 	TargetedActor = TargetActors[MinIdx];
 }
 
@@ -77,20 +199,11 @@ void UTargetComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 	
-	DOREPLIFETIME(UTargetComponent, TargetedActor);
+	DOREPLIFETIME_CONDITION(UTargetComponent, TargetedActor, COND_OwnerOnly);
 	DOREPLIFETIME(UTargetComponent, Interval);
 }
 
 void UTargetComponent::ServerSetInterval_Implementation(float InInterval)
 {
 	Interval = InInterval;
-	SetComponentTickInterval(Interval);
-}
-
-void UTargetComponent::OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus)
-{
-	if (Stimulus.IsActive() && !Cast<APRCharacter>(Actor)->IsDeath())
-		TargetActors.AddUnique(Actor);
-	else
-		TargetActors.Remove(Actor);
 }
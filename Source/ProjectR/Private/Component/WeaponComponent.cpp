@@ -9,28 +9,37 @@
 #include "Component/WeaponMeshComponent.h"
 #include "Framework/PRCharacter.h"
 #include "Framework/PRAnimInstance.h"
+#include "Interface/Executable.h"
+#include "Interface/StateExecutable.h"
 #include "Misc/SkillContext.h"
-#include "Misc/Weapon.h"
+#include "Skill/Skill.h"
+#include "Subsystem/CombatDataSubsystem.h"
+#include "Subsystem/CombatTickSubsystem.h"
 
 UWeaponComponent::UWeaponComponent()
 	: Super()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
 	bWantsInitializeComponent = true;
 	SetIsReplicatedByDefault(true);
 	
 	WeaponSwapDuration = 0.2f;
-	SkillIndex = 255u;
+	InputBufferTime = 0.2f;
+	InputResendInterval = 0.05f;
+	ClientTimeOffset = TNumericLimits<float>::Max();
+	ComboNode = INDEX_NONE;
+	PredictedSkill = nullptr;
+	EquippedKey = UCombatDataSubsystem::InvalidKey;
 }
 
 void UWeaponComponent::Attack(bool bIsStrongAttack)
 {
-	ServerAttack(bIsStrongAttack);
+	AddInput(bIsStrongAttack ? ECombatInputType::StrongAttack : ECombatInputType::WeakAttack);
 }
 
 void UWeaponComponent::Dodge()
 {
-	ServerDodge();
+	AddInput(ECombatInputType::Dodge);
 }
 
 void UWeaponComponent::StopSkill()
@@ -40,49 +49,61 @@ void UWeaponComponent::StopSkill()
 
 void UWeaponComponent::SwapWeapon(uint8 Index)
 {
-	ServerSwapWeapon(Index);
+	AddInput(ECombatInputType::Swap, Index);
 }
 
 void UWeaponComponent::ChangeWeapon(uint8 Index, int32 Key)
 {
-	ServerChangeWeapon(Index, Key);
+	if (Key >= 0 && Key < UCombatDataSubsystem::InvalidKey)
+		ServerChangeWeapon(Index, static_cast<uint8>(Key));
 }
 
 void UWeaponComponent::AddWeapon(int32 Key)
 {
-	ServerAddWeapon(Key);
+	if (Key >= 0 && Key < UCombatDataSubsystem::InvalidKey)
+		ServerAddWeapon(static_cast<uint8>(Key));
 }
 
 void UWeaponComponent::Execute()
 {
-	if (GetOwner()->HasAuthority() && Weapons.IsValidIndex(WeaponIndex))
-		Weapons[WeaponIndex]->Execute(CombatState == ECombatState::Dodge ? 0u : SkillIndex + 1);
+	if (GetOwner()->HasAuthority() && ActiveSkill &&
+		ActiveSkill->GetClass()->ImplementsInterface(UExecutable::StaticClass()))
+		IExecutable::Execute_Execute(ActiveSkill);
 }
 
 void UWeaponComponent::BeginExecute()
 {
-	if (GetOwner()->HasAuthority() && Weapons.IsValidIndex(WeaponIndex))
-		Weapons[WeaponIndex]->BeginExecute(CombatState == ECombatState::Dodge ? 0u : SkillIndex + 1);
+	if (GetOwner()->HasAuthority() && ActiveSkill &&
+		ActiveSkill->GetClass()->ImplementsInterface(UStateExecutable::StaticClass()))
+		IStateExecutable::Execute_BeginExecute(ActiveSkill);
 }
 
 void UWeaponComponent::EndExecute()
 {
-	if (GetOwner()->HasAuthority() && Weapons.IsValidIndex(WeaponIndex))
-		Weapons[WeaponIndex]->EndExecute(CombatState == ECombatState::Dodge ? 0u : SkillIndex + 1);
+	if (GetOwner()->HasAuthority() && ActiveSkill &&
+		ActiveSkill->GetClass()->ImplementsInterface(UStateExecutable::StaticClass()))
+		IStateExecutable::Execute_EndExecute(ActiveSkill);
 }
 
 void UWeaponComponent::EnableCombo()
 {
+	if (GetOwnerRole() == ENetRole::ROLE_AutonomousProxy)
+		bPredictedCombo = true;
+
 	if (GetOwner()->HasAuthority()
 		&& Weapons.IsValidIndex(WeaponIndex))
 	{
 		bNowCombo = true;
 		OnEnableCombo.Broadcast();
+		ConsumeInputs();
 	}
 }
 
 void UWeaponComponent::DisableCombo()
 {
+	if (GetOwnerRole() == ENetRole::ROLE_AutonomousProxy)
+		bPredictedCombo = false;
+
 	if (GetOwner()->HasAuthority()
 		&& Weapons.IsValidIndex(WeaponIndex))
 	{
@@ -98,11 +119,24 @@ void UWeaponComponent::SetLevel(uint8 InLevel)
 
 void UWeaponComponent::OnEndSkill()
 {
-	if (!bNowCombo)
-		SkillIndex = 255u;
+	if (!bNowCombo && !bPredictedCombo)
+		ComboNode = INDEX_NONE;
+
+	if (ActiveSkill)
+		if (auto* TickSubsystem = UCombatTickSubsystem::Get(this))
+			TickSubsystem->UnregisterSkill(ActiveSkill);
 	
+	ActiveSkill = nullptr;
 	CombatState = ECombatState::None;
 	OnStopSkill.Broadcast();
+
+	if (GetOwner()->HasAuthority())
+		ConsumeInputs();
+}
+
+bool UWeaponComponent::IsPredictedAnimation(const UAnimMontage* Animation) const noexcept
+{
+	return Predictions.Contains(Animation);
 }
 
 void UWeaponComponent::SetWeaponComponent(UWeaponMeshComponent* InRightWeapon,
@@ -142,10 +176,6 @@ void UWeaponComponent::BeginPlay()
 	
 	auto* User = Cast<APRCharacter>(GetOwner());
 	User->OnDeath.AddDynamic(this, &UWeaponComponent::Detach);
-
-	if (GetOwnerRole() == ENetRole::ROLE_Authority)
-		for (auto* Weapon : Weapons)
-			Weapon->InitSkill(Level);
 }
 
 void UWeaponComponent::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -153,24 +183,26 @@ void UWeaponComponent::EndPlay(EEndPlayReason::Type EndPlayReason)
 	Cast<APRCharacter>(GetOwner())->OnDeath.
 		RemoveDynamic(this, &UWeaponComponent::Detach);
 
-	Super::EndPlay(EndPlayReason);
-}
+	if (ActiveSkill)
+		if (auto* TickSubsystem = UCombatTickSubsystem::Get(this))
+			TickSubsystem->UnregisterSkill(ActiveSkill);
 
-void UWeaponComponent::TickComponent(float DeltaTime,
-	ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (GetNetMode() == NM_Client)
+		if (auto* Registry = UCombatDataSubsystem::Get(this))
+			Registry->UnregisterLoadout(GetOwner());
 
-	if (GetOwner()->HasAuthority() && Weapons.IsValidIndex(WeaponIndex) && CombatState != ECombatState::None)
-		Weapons[WeaponIndex]->TickSkill(CombatState == ECombatState::Dodge ? 0u : SkillIndex + 1, DeltaTime);
+	Super::EndPlay(EndPlayReason);
 }
 
 void UWeaponComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UWeaponComponent, VisualData);
 	DOREPLIFETIME(UWeaponComponent, Level);
+	DOREPLIFETIME(UWeaponComponent, Keies);
+	DOREPLIFETIME(UWeaponComponent, EquippedKey);
+	DOREPLIFETIME(UWeaponComponent, WeaponIndex);
+	DOREPLIFETIME_CONDITION(UWeaponComponent, LastInputSequence, COND_OwnerOnly);
 	DOREPLIFETIME(UWeaponComponent, bNowCombo);
 }
 
@@ -178,13 +210,24 @@ void UWeaponComponent::EquipWeapon(UWeapon* NewWeapon)
 {
 	if (!NewWeapon) return;
 
-	NewWeapon->RegisterOnAsyncLoadEnded(
-		FOnAsyncLoadEndedSingle::CreateLambda([this, NewWeapon]
-		{
-			VisualData = NewWeapon->GetVisualData();
-			OnRep_VisualData();
-		}
-	));
+	EquippedKey = NewWeapon->GetKey();
+	LoadVisualData(NewWeapon);
+}
+
+void UWeaponComponent::LoadVisualData(UWeapon* Weapon)
+{
+	Weapon->RegisterOnAsyncLoadEnded(FOnAsyncLoadEndedSingle
+		::CreateUObject(this, &UWeaponComponent::OnWeaponLoaded, Weapon));
+}
+
+void UWeaponComponent::OnWeaponLoaded(UWeapon* Weapon)
+{
+	// A later equip may have finished loading first.
+	if (Weapon->GetKey() != EquippedKey)
+		return;
+
+	VisualData = Weapon->GetVisualData();
+	ApplyVisualData();
 }
 
 void UWeaponComponent::Initialize()
@@ -194,17 +237,14 @@ void UWeaponComponent::Initialize()
 
 	SkillContext = NewObject<USkillContext>(this);
 
-	if (!NoWeapon) NoWeapon = NewObject<UWeapon>(GetOwner());
-	NoWeapon->Initialize(SkillContext, 0u);
-
 	Weapons.Empty();
 	int32 WeaponNum = Keies.Num();
 	for (int32 Idx = 0; Idx < WeaponNum; ++Idx)
 	{
-		UWeapon* Weapon = NewObject<UWeapon>(GetOwner());
-		if (Weapon->Initialize(SkillContext, Keies[Idx]))
+		FWeaponState State;
+		if (MakeWeaponState(Keies[Idx], State))
 		{
-			Weapons.Add(Weapon);
+			Weapons.Add(State);
 			continue;
 		}
 		
@@ -213,103 +253,366 @@ void UWeaponComponent::Initialize()
 		--Idx;
 	}
 
-	EquipWeapon(Weapons.Num() > 0 ? Weapons[0] : NoWeapon);
+	if (Weapons.Num() > 0)
+	{
+		EquipWeapon(Weapons[0].Weapon);
+	}
+	else if (auto* Registry = UCombatDataSubsystem::Get(this))
+	{
+		EquipWeapon(Registry->GetWeapon(0u));
+	}
+}
+
+bool UWeaponComponent::MakeWeaponState(uint8 Key, FWeaponState& OutState)
+{
+	auto* Registry = UCombatDataSubsystem::Get(this);
+	OutState.Weapon = Registry ? Registry->GetWeapon(Key) : nullptr;
+	OutState.SkillData = nullptr;
+	return OutState.Weapon != nullptr;
 }
 
-void UWeaponComponent::ServerAttack_Implementation(bool bIsStrongAttack)
+void UWeaponComponent::BeginSkill(int32 Node)
 {
-	if (bBlockSkill || (CombatState != ECombatState::None &&
-		!bNowCombo) || !Weapons.IsValidIndex(WeaponIndex)) return;
+	FWeaponState& State = Weapons[WeaponIndex];
 
-	if (bNowCombo)
+	USkill* Skill = GetSkillInstance(State.Weapon->GetSkillClass(Node));
+	if (!Skill || !Skill->CanUseSkill())
 	{
-		ServerStopSkill_Implementation();
-		bNowCombo = false;
+		OnEndSkill();
+		return;
 	}
 
-	SkillIndex = SkillIndex != 255u ? (2u * SkillIndex) + 2u : 0u;
-	if (bIsStrongAttack) ++SkillIndex;
+	if (!State.SkillData)
+		if (auto* Registry = UCombatDataSubsystem::Get(this))
+			State.SkillData = Registry->ResolveSkills(State.Weapon->GetKey(), Level);
+
+	const auto* SkillData = State.SkillData;
+	ActiveSkill = Skill;
+
+	if (auto* TickSubsystem = UCombatTickSubsystem::Get(this))
+		TickSubsystem->RegisterSkill(Skill);
 
-	CombatState = ECombatState::Attack;
-	Weapons[WeaponIndex]->BeginSkill(SkillIndex + 1u);
-	OnAttack.Broadcast();
+	Skill->Begin(SkillContext, SkillData && SkillData->IsValidIndex(Node) ? (*SkillData)[Node] : nullptr);
 }
 
-void UWeaponComponent::ServerDodge_Implementation()
+USkill* UWeaponComponent::GetSkillInstance(UClass* SkillClass)
 {
-	if (bBlockSkill || CombatState == ECombatState::Dodge ||
-		(CombatState != ECombatState::None && !bNowCombo) ||
-		!Weapons.IsValidIndex(WeaponIndex)) return;
+	if (!SkillClass) return nullptr;
 
-	if (bNowCombo)
+	USkill*& Skill = SkillInstances.FindOrAdd(SkillClass);
+	if (!Skill)
 	{
-		ServerStopSkill_Implementation();
-		bNowCombo = false;
+		Skill = NewObject<USkill>(GetOwner(), SkillClass);
+		Skill->Initialize();
 	}
-	
-	CombatState = ECombatState::Dodge;
-	Weapons[WeaponIndex]->BeginSkill(0u);
-	OnDodge.Broadcast();
+
+	return Skill;
 }
 
-void UWeaponComponent::ServerStopSkill_Implementation()
+void UWeaponComponent::ServerSendInputs_Implementation(const TArray<FCombatInput>& Inputs)
 {
-	if (CombatState != ECombatState::None && Weapons.IsValidIndex(WeaponIndex))
-		Weapons[WeaponIndex]->EndSkill(CombatState == ECombatState::Dodge ? 0u : SkillIndex + 1u);
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (const FCombatInput& Input : Inputs)
+	{
+		if (!Input.IsNewerThan(LastInputSequence))
+			continue;
+
+		LastInputSequence = Input.Sequence;
+		ClientTimeOffset = FMath::Min(ClientTimeOffset, Now - Input.Timestamp);
+		BufferInput(Input);
+	}
+
+	ConsumeInputs();
 }
 
-void UWeaponComponent::ServerSwapWeapon_Implementation(uint8 Index)
+void UWeaponComponent::ServerStopSkill_Implementation()
 {
-	if (bBlockSkill || (CombatState != ECombatState::None
-		&& !bNowCombo) || WeaponIndex == Index) return;
-
-	EquipWeapon(Weapons[Index]);
-	WeaponIndex = Index;
+	if (CombatState != ECombatState::None && ActiveSkill)
+		ActiveSkill->End();
 }
 
-void UWeaponComponent::ServerChangeWeapon_Implementation(uint8 Index, int32 Key)
+void UWeaponComponent::ServerChangeWeapon_Implementation(uint8 Index, uint8 Key)
 {
 	if (bBlockSkill || CombatState != ECombatState::None ||
-		!Weapons.IsValidIndex(Index) || Weapons[Index]->GetKey() == Key)
+		!Weapons.IsValidIndex(Index) || Weapons[Index].Weapon->GetKey() == Key)
 		return;
 
-	auto* NewWeapon = NewObject<UWeapon>(GetOwner());
-	NewWeapon->Initialize(SkillContext, Key);
-	NewWeapon->InitSkill(Level);
+	FWeaponState NewState;
+	if (!MakeWeaponState(Key, NewState))
+		return;
 
 	if (Index == WeaponIndex)
-		EquipWeapon(NewWeapon);
+		EquipWeapon(NewState.Weapon);
 
-	Weapons[Index] = NewWeapon;
+	Weapons[Index] = NewState;
+	Keies[Index] = Key;
 }
 
-void UWeaponComponent::ServerAddWeapon_Implementation(int32 Key)
+void UWeaponComponent::ServerAddWeapon_Implementation(uint8 Key)
 {
 	if (bBlockSkill || CombatState != ECombatState::None) return;
 
-	UWeapon* NewWeapon = NoWeapon;
-	
-	if (Key != 0)
-	{
-		NewWeapon = NewObject<UWeapon>(GetOwner());
-		NewWeapon->Initialize(SkillContext, Key);
-	}
+	FWeaponState NewState;
+	if (!MakeWeaponState(Key, NewState))
+		return;
 
-	NewWeapon->InitSkill(Level);
 	if (Weapons.Num() == 0)
-		EquipWeapon(NewWeapon);
+		EquipWeapon(NewState.Weapon);
 
-	Weapons.Add(NewWeapon);
+	Weapons.Add(NewState);
+	Keies.Add(Key);
 }
 
 void UWeaponComponent::ServerSetLevel_Implementation(uint8 InLevel)
 {
 	Level = InLevel;
-	for (auto* Weapon : Weapons)
-		Weapon->InitSkill(Level);
+	for (auto& State : Weapons)
+		State.SkillData = nullptr;
+}
+
+void UWeaponComponent::ClientConfirmSkill_Implementation(uint16 Sequence, bool bIsAccepted)
+{
+	TArray<UAnimMontage*> RolledBack;
+	if (!Predictions.Confirm(Sequence, bIsAccepted, RolledBack) || bIsAccepted)
+		return;
+
+	auto* User = Cast<APRCharacter>(GetOwner());
+	for (UAnimMontage* Montage : RolledBack)
+		User->StopAnimMontage(Montage);
+
+	EndPrediction();
+
+	// The server ends the combo on every rejected input, so the graph restarts from the root on both sides.
+	ComboNode = INDEX_NONE;
+	CombatState = ECombatState::None;
+	bPredictedCombo = false;
+	OnStopSkill.Broadcast();
+}
+
+void UWeaponComponent::AddInput(ECombatInputType Type, uint8 Index)
+{
+	if (++InputSequence == 0u)
+		++InputSequence;
+
+	FCombatInput Input;
+	Input.Timestamp = GetWorld()->GetTimeSeconds();
+	Input.Sequence = InputSequence;
+	Input.Type = Type;
+	Input.Index = Index;
+	Input.bIsPredicted = false;
+
+	if (GetOwner()->HasAuthority())
+	{
+		ClientTimeOffset = 0.0f;
+		BufferInput(Input);
+		ConsumeInputs();
+		return;
+	}
+
+	if (Type != ECombatInputType::Swap)
+	{
+		const bool bIsDodge = Type == ECombatInputType::Dodge;
+		Input.bIsPredicted = PredictSkill(bIsDodge ? ECombatState::Dodge : ECombatState::Attack,
+			Type == ECombatInputType::StrongAttack, Input.Sequence);
+	}
+
+	if (PendingInputs.Num() == MaxInputNum)
+	{
+		if (PendingInputs[0].bIsPredicted)
+			ClientConfirmSkill_Implementation(PendingInputs[0].Sequence, false);
+
+		PendingInputs.RemoveAt(0);
+	}
+
+	PendingInputs.Add(Input);
+
+	// Every input pressed this frame goes out in a single batch on the next tick.
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	TimerManager.ClearTimer(FlushTimer);
+	FlushTimer = TimerManager.SetTimerForNextTick(this, &UWeaponComponent::FlushInputs);
+}
+
+void UWeaponComponent::FlushInputs()
+{
+	// Inputs are resent until the replicated sequence acknowledges them.
+	PendingInputs.RemoveAll([this](const FCombatInput& Input)
+		{ return !Input.IsNewerThan(LastInputSequence); });
+	
+	if (PendingInputs.Num() == 0)
+		return;
+
+	ServerSendInputs(PendingInputs);
+	GetWorld()->GetTimerManager().SetTimer(FlushTimer, this,
+		&UWeaponComponent::FlushInputs, InputResendInterval, false);
+}
+
+void UWeaponComponent::BufferInput(const FCombatInput& Input)
+{
+	if (InputBuffer.Num() == MaxInputNum)
+	{
+		if (InputBuffer[0].bIsPredicted)
+		{
+			if (InputBuffer[0].Type != ECombatInputType::Swap)
+				ComboNode = INDEX_NONE;
+
+			ClientConfirmSkill(InputBuffer[0].Sequence, false);
+		}
+
+		InputBuffer.RemoveAt(0);
+	}
+
+	InputBuffer.Add(Input);
 }
 
-void UWeaponComponent::OnRep_VisualData()
+void UWeaponComponent::ConsumeInputs()
+{
+	if (bIsConsumingInput) return;
+	bIsConsumingInput = true;
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	while (InputBuffer.Num() > 0)
+	{
+		const FCombatInput Input = InputBuffer[0];
+		// A client clock running ahead would otherwise keep its inputs from ever expiring.
+		const float InputTime = FMath::Min(Input.Timestamp + ClientTimeOffset, Now);
+		const bool bIsExpired = Now - InputTime > InputBufferTime;
+		if (!bIsExpired && !CanExecuteInput(Input))
+			break;
+
+		InputBuffer.RemoveAt(0);
+		const bool bIsAccepted = !bIsExpired && ExecuteInput(Input);
+
+		// Only a rejected prediction ends the combo, as the owner learns of it and resets too.
+		// Unpredicted presses that expire are dropped like before, leaving a running combo alone.
+		if (Input.bIsPredicted)
+		{
+			if (!bIsAccepted && Input.Type != ECombatInputType::Swap)
+				ComboNode = INDEX_NONE;
+
+			ClientConfirmSkill(Input.Sequence, bIsAccepted);
+		}
+	}
+
+	bIsConsumingInput = false;
+
+	if (InputBuffer.Num() > 0)
+	{
+		GetWorld()->GetTimerManager().SetTimer(ConsumeTimer, this,
+			&UWeaponComponent::ConsumeInputs, InputBufferTime, false);
+	}
+}
+
+bool UWeaponComponent::CanExecuteInput(const FCombatInput& Input) const noexcept
+{
+	if (bBlockSkill || (CombatState != ECombatState::None && !bNowCombo))
+		return false;
+
+	if (Input.Type == ECombatInputType::Swap)
+		return Weapons.IsValidIndex(Input.Index) && WeaponIndex != Input.Index;
+
+	if (Input.Type == ECombatInputType::Dodge && CombatState == ECombatState::Dodge)
+		return false;
+
+	return Weapons.IsValidIndex(WeaponIndex);
+}
+
+bool UWeaponComponent::ExecuteInput(const FCombatInput& Input)
+{
+	if (bNowCombo && Input.Type != ECombatInputType::Swap)
+	{
+		ServerStopSkill_Implementation();
+		bNowCombo = false;
+	}
+
+	switch (Input.Type)
+	{
+	case ECombatInputType::WeakAttack:
+	case ECombatInputType::StrongAttack:
+		ComboNode = Weapons[WeaponIndex].Weapon->GetNextNode(ComboNode,
+			Input.Type == ECombatInputType::StrongAttack);
+
+		CombatState = ECombatState::Attack;
+		BeginSkill(ComboNode);
+		OnAttack.Broadcast();
+		return ActiveSkill != nullptr;
+
+	case ECombatInputType::Dodge:
+		CombatState = ECombatState::Dodge;
+		BeginSkill(FComboGraph::DodgeNode);
+		OnDodge.Broadcast();
+		return ActiveSkill != nullptr;
+
+	case ECombatInputType::Swap:
+		EquipWeapon(Weapons[Input.Index].Weapon);
+		WeaponIndex = Input.Index;
+		return true;
+	}
+
+	return false;
+}
+
+bool UWeaponComponent::PredictSkill(ECombatState NewState, bool bIsStrongAttack, uint16 Sequence)
+{
+	if (GetOwnerRole() != ENetRole::ROLE_AutonomousProxy || bBlockSkill ||
+		(CombatState != ECombatState::None && !bPredictedCombo) ||
+		(NewState == ECombatState::Dodge && CombatState == ECombatState::Dodge))
+		return false;
+
+	auto* Registry = UCombatDataSubsystem::Get(this);
+	const UWeapon* Weapon = Registry ? Registry->GetWeapon(EquippedKey) : nullptr;
+	if (!Weapon) return false;
+
+	const int32 Node = NewState == ECombatState::Dodge ?
+		FComboGraph::DodgeNode : Weapon->GetNextNode(ComboNode, bIsStrongAttack);
+
+	const auto* SkillClass = Weapon->GetSkillClass(Node);
+	const auto* SkillData = Registry->ResolveSkills(EquippedKey, Level);
+	if (!SkillClass || !SkillData || !SkillData->IsValidIndex(Node))
+		return false;
+
+	auto* User = Cast<APRCharacter>(GetOwner());
+	UAnimMontage* Montage = SkillClass->GetDefaultObject<USkill>()->GetPredictedAnimation(User, (*SkillData)[Node]);
+	if (!Montage || User->PlayAnimMontage(Montage) <= 0.0f)
+		return false;
+
+	FOnMontageEnded OnMontageEnded = FOnMontageEnded::CreateUObject(this, &UWeaponComponent::OnPredictedMontageEnded, Sequence);
+	User->GetMesh()->GetAnimInstance()->Montage_SetEndDelegate(OnMontageEnded, Montage);
+
+	// The new skill replaces the predicted one, as beginning it ends the active skill on the server.
+	EndPrediction();
+	Predictions.Add(Montage, Sequence);
+
+	PredictedSkill = SkillClass->GetDefaultObject<USkill>();
+	PredictedSkill->BeginPrediction(User, (*SkillData)[Node]);
+
+	if (NewState == ECombatState::Attack)
+		ComboNode = Node;
+
+	CombatState = NewState;
+	bPredictedCombo = false;
+	return true;
+}
+
+void UWeaponComponent::OnPredictedMontageEnded(UAnimMontage* Montage, bool bInterrupted, uint16 Sequence)
+{
+	// Interrupted ends count too, since a server stop or a multicast montage can cut the prediction short.
+	if (!Predictions.End(Montage, Sequence))
+		return;
+
+	EndPrediction();
+	OnEndSkill();
+	bPredictedCombo = false;
+}
+
+void UWeaponComponent::EndPrediction()
+{
+	if (PredictedSkill)
+		PredictedSkill->EndPrediction(Cast<APRCharacter>(GetOwner()));
+
+	PredictedSkill = nullptr;
+}
+
+void UWeaponComponent::ApplyVisualData()
 {
 	RightWeapon->SetWeapon(VisualData.RightMesh, VisualData.RightAnim, VisualData.RightTransform);
 	LeftWeapon->SetWeapon(VisualData.LeftMesh, VisualData.LeftAnim, VisualData.LeftTransform);
@@ -320,3 +623,18 @@ void UWeaponComponent::Detach()
 	RightWeapon->Detach();
 	LeftWeapon->Detach();
 }
+
+void UWeaponComponent::OnRep_EquippedKey()
+{
+	if (auto* Registry = UCombatDataSubsystem::Get(this))
+		if (UWeapon* Weapon = Registry->GetWeapon(EquippedKey))
+			LoadVisualData(Weapon);
+
+	OnRep_Loadout();
+}
+
+void UWeaponComponent::OnRep_Loadout()
+{
+	if (auto* Registry = UCombatDataSubsystem::Get(this))
+		Registry->RegisterLoadout(GetOwner(), Keies, EquippedKey);
+}
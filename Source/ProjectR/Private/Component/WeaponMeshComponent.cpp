@@ -2,6 +2,7 @@
 
 #include "Component/WeaponMeshComponent.h"
 #include "Component/WeaponComponent.h"
+#include "Subsystem/CombatTickSubsystem.h"
 
 UWeaponMeshComponent::UWeaponMeshComponent()
 	: Super()
@@ -42,6 +43,9 @@ void UWeaponMeshComponent::SetWeapon(USkeletalMesh* Mesh,
 
 	SetMaterial(0, SwapMaterial);
 	SwapRatio = 1.0f;
+
+	if (auto* TickSubsystem = UCombatTickSubsystem::Get(this))
+		TickSubsystem->RegisterSwap(this);
 }
 
 void UWeaponMeshComponent::Detach()
@@ -51,14 +55,12 @@ void UWeaponMeshComponent::Detach()
 
 	const auto Rules = FDetachmentTransformRules::KeepWorldTransform;
 	DetachFromComponent(Rules);
+	SetComponentTickEnabled(true);
 }
 
-void UWeaponMeshComponent::TickComponent(float DeltaTime, ELevelTick TickType,
-	FActorComponentTickFunction* ThisTickFunction)
+bool UWeaponMeshComponent::TickSwap(float DeltaTime)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	if (SwapRatio <= 0.0f) return;
+	if (SwapRatio <= 0.0f) return false;
 
 	auto* WeaponComp = Cast<UWeaponComponent>(GetOwner()
 		->GetComponentByClass(UWeaponComponent::StaticClass()));
@@ -66,16 +68,16 @@ void UWeaponMeshComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 	check(WeaponComp);
 
 	float SwapDuration = WeaponComp->GetWeaponSwapDuration();
-	if (SwapDuration <= 0.0f) return;
+	if (SwapDuration <= 0.0f) return false;
 	
 	if (bNeedFast) SwapDuration *= 0.5f;
-	SwapRatio -= GetWorld()->GetDeltaSeconds() / SwapDuration;
+	SwapRatio -= DeltaTime / SwapDuration;
 	SwapRatio = FMath::Max(SwapRatio, 0.0f);
 
 	if (bNowDecrease)
 	{
 		if (SetScaleIfNeed(FVector{ 0.01f }, BeforeScale))
-			return;
+			return true;
 
 		SetMesh(OriginalMesh, OriginalAnim, OriginalTransform.GetLocation(), OriginalTransform.GetRotation());
 		bNowDecrease = false;
@@ -90,6 +92,8 @@ void UWeaponMeshComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 		SetRelativeScale3D(OriginalTransform.GetScale3D());
 		EmptyOverrideMaterials();
 	}
+
+	return SwapRatio > 0.0f;
 }
 
 void UWeaponMeshComponent::SetMesh(USkeletalMesh* Mesh,
@@ -97,6 +101,9 @@ void UWeaponMeshComponent::SetMesh(USkeletalMesh* Mesh,
 {
 	SetAnimClass(Anim);
 	SetSkeletalMesh(Mesh);
+
+	// Only an animated weapon needs the skeletal mesh tick; swaps are ticked by the subsystem.
+	SetComponentTickEnabled(Anim != nullptr);
 	SetRelativeLocationAndRotation(Loc, Rot);
 }
 
@@ -2,22 +2,25 @@
 
 #include "Framework/PRCharacter.h"
 #include "Components/CapsuleComponent.h"
-#include "Engine/DataTable.h"
 #include "GameFramework/Controller.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Net/UnrealNetwork.h"
-#include "UObject/ConstructorHelpers.h"
-#include "Perception/AISense_Damage.h"
 #include "Component/PRMovementComponent.h"
 #include "Component/WeaponComponent.h"
 #include "Component/WeaponMeshComponent.h"
 #include "Data/CharacterData.h"
 #include "Library/PRStatics.h"
+#include "Subsystem/CombatDataSubsystem.h"
+#include "Subsystem/DamageSubsystem.h"
+#include "Subsystem/GroundSubsystem.h"
+#include "Subsystem/HitboxSubsystem.h"
+#include "Subsystem/LockOnSubsystem.h"
+#include "Subsystem/MovementLODSubsystem.h"
+#include "Subsystem/TargetingSubsystem.h"
 
 APRCharacter::APRCharacter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass<UPRMovementComponent>(CharacterMovementComponentName))
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 	
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationYaw = false;
@@ -25,9 +28,6 @@ APRCharacter::APRCharacter(const FObjectInitializer& ObjectInitializer)
 
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 	GetCapsuleComponent()->SetCollisionProfileName(TEXT("Pawn"));
-	
-	static ConstructorHelpers::FObjectFinder<UDataTable> DataTable(TEXT("DataTable'/Game/Data/DataTable/DT_CharacterData.DT_CharacterData'"));
-	CharacterDataTable = DataTable.Object;
 
 	RightWeapon = CreateDefaultSubobject<UWeaponMeshComponent>(TEXT("RightWeapon"));
 	LeftWeapon = CreateDefaultSubobject<UWeaponMeshComponent>(TEXT("LeftWeapon"));
@@ -61,13 +61,38 @@ void APRCharacter::SetMaxHealth(float NewMaxHealth, bool bWithCurrent)
 	}
 }
 
+void APRCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* Hitboxes = UHitboxSubsystem::Get(this))
+		Hitboxes->Unregister(this);
+
+	if (auto* Targeting = UTargetingSubsystem::Get(this))
+		Targeting->UnregisterCharacter(this);
+
+	if (auto* LockOn = ULockOnSubsystem::Get(this))
+		LockOn->Unregister(this);
+
+	if (auto* MovementLOD = UMovementLODSubsystem::Get(this))
+		MovementLOD->Unregister(this);
+
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->CancelHandle();
+		LoadHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void APRCharacter::Lock(AActor* NewLockTarget)
 {
+	PredictLock(true);
 	ServerLock(NewLockTarget);
 }
 
 void APRCharacter::Unlock()
 {
+	PredictLock(false);
 	ServerUnlock();
 }
 
@@ -84,35 +109,6 @@ void APRCharacter::PostEditChangeProperty(FPropertyChangedEvent& PropertyChanged
 
 #endif
 
-void APRCharacter::Tick(float DeltaSeconds)
-{
-	Super::Tick(DeltaSeconds);
-	if (!LockedTarget) return;
-
-	if (!IsMoveInputIgnored() || WeaponComp->IsCheckingCombo())
-	{
-		const FVector MyLoc = GetActorLocation();
-		const FVector TargetLoc = LockedTarget->GetActorLocation();
-
-		FRotator ActorRot = UKismetMathLibrary::FindLookAtRotation(MyLoc, TargetLoc);
-		ActorRot = FMath::Lerp(GetActorRotation(), ActorRot, DeltaSeconds * 10.0f);
-		SetActorRotation(FRotator{ 0.0f, ActorRot.Yaw, 0.0f });
-	}
-
-	if (AController* MyController = GetController())
-	{
-		FVector MyEyeLoc; FRotator MyEyeRot;
-		GetActorEyesViewPoint(MyEyeLoc, MyEyeRot);
-
-		FVector TargetEyeLoc; FRotator TargetEyeRot;
-		LockedTarget->GetActorEyesViewPoint(TargetEyeLoc, TargetEyeRot);
-
-		FRotator CtrlRot = UKismetMathLibrary::FindLookAtRotation(MyEyeLoc, TargetEyeLoc);
-		CtrlRot = FMath::Lerp(MyController->GetControlRotation(), CtrlRot, DeltaSeconds * 8.0f);
-		MyController->SetControlRotation(CtrlRot);
-	}
-}
-
 void APRCharacter::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
@@ -128,6 +124,15 @@ void APRCharacter::BeginPlay()
 		WeaponComp->SetComponents(GetAttackComponents());
 		Health = MaxHealth;
 		OnRep_Health();
+
+		if (auto* Hitboxes = UHitboxSubsystem::Get(this))
+			Hitboxes->Register(this);
+
+		if (auto* Targeting = UTargetingSubsystem::Get(this))
+			Targeting->RegisterCharacter(this);
+
+		if (auto* MovementLOD = UMovementLODSubsystem::Get(this))
+			MovementLOD->Register(this);
 	}
 }
 
@@ -143,11 +148,8 @@ float APRCharacter::TakeDamage(float Damage, const FDamageEvent& DamageEvent,
 	if (Health == 0.0f) Death();
 
 	if (auto* InstigatorPawn = EventInstigator->GetPawn<APRCharacter>())
-	{
-		MulticastOnHit(Damage, InstigatorPawn);
-		UAISense_Damage::ReportDamageEvent(GetWorld(), this, InstigatorPawn,
-			Damage, InstigatorPawn->GetActorLocation(), GetActorLocation());
-	}
+		if (auto* Damages = UDamageSubsystem::Get(this))
+			Damages->AddHit(this, Damage, InstigatorPawn);
 
 	return Damage;
 }
@@ -173,16 +175,17 @@ void APRCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLife
 
 void APRCharacter::Initialize()
 {
-	if (CharacterDataTable)
+	if (const auto* Registry = UCombatDataSubsystem::Get(this))
 	{
-		if (const auto* Data = CharacterDataTable->FindRow<FCharacterData>
-			(FName{ *FString::FromInt(CharacterKey) }, TEXT(""), false))
+		if (const auto* Data = Registry->FindCharacterData(CharacterKey))
 		{
-			UPRStatics::AsyncLoad(Data->Mesh, [this, Data] { ApplyCharacterData(*Data); });
+			if (LoadHandle.IsValid())
+				LoadHandle->CancelHandle();
+
+			LoadHandle = UPRStatics::AsyncLoadMany(this, { Data->Mesh.ToSoftObjectPath() },
+				[this, Data] { ApplyCharacterData(*Data); }, FStreamableManager::AsyncLoadHighPriority);
 			return;
 		}
-		
-		UE_LOG(LogDataTable, Error, TEXT("Cannot found character data %d!"), CharacterKey);
 	}
 
 	ApplyCharacterData(FCharacterData{});
@@ -200,10 +203,16 @@ void APRCharacter::ServerLock_Implementation(AActor* NewLockTarget)
 {
 	LockedTarget = NewLockTarget;
 
+	// Skills such as Leap land below the locked target, so its ground starts being sampled now.
+	float GroundHeight;
+	if (auto* Ground = UGroundSubsystem::Get(this))
+		Ground->GetGroundHeight(NewLockTarget, GroundHeight);
+
 	const bool bWasLocked = bIsLocked;
 	bIsLocked = true;
 
 	if (!bWasLocked) OnRep_IsLocked();
+	else UpdateLock();
 }
 
 void APRCharacter::ServerUnlock_Implementation()
@@ -216,11 +225,6 @@ void APRCharacter::ServerUnlock_Implementation()
 	if (bWasLocked) OnRep_IsLocked();
 }
 
-void APRCharacter::MulticastOnHit_Implementation(float Damage, APRCharacter* Causer)
-{
-	OnDamaged.Broadcast(Damage, Causer);
-}
-
 void APRCharacter::MulticastDeath_Implementation()
 {
 	bIsDeath = true;
@@ -236,12 +240,46 @@ void APRCharacter::MulticastDeath_Implementation()
 	OnDeath.Broadcast();
 }
 
+void APRCharacter::PredictLock(bool bIsLock)
+{
+	// The owner applies the lock state at once; the server still decides the target.
+	if (HasAuthority() || !IsLocallyControlled() || bIsLocked == bIsLock)
+		return;
+
+	bIsLocked = bIsLock;
+	OnRep_IsLocked();
+}
+
 void APRCharacter::OnRep_IsLocked()
 {
-	Cast<UPRMovementComponent>(GetCharacterMovement())->ApplyLock(bIsLocked);
+	// The server moves a remote player with the lock state carried in its saved moves.
+	const bool bIsRemotePlayer = HasAuthority() && IsPlayerControlled() && !IsLocallyControlled();
+	if (!bIsRemotePlayer)
+		Cast<UPRMovementComponent>(GetCharacterMovement())->ApplyLock(bIsLocked);
+
+	UpdateLock();
 	OnLocked.Broadcast(true);
 }
 
+void APRCharacter::OnRep_LockedTarget()
+{
+	UpdateLock();
+}
+
+void APRCharacter::UpdateLock()
+{
+	AActor* Target = bIsLocked ? LockedTarget : nullptr;
+	Cast<UPRMovementComponent>(GetCharacterMovement())->SetLockTarget(Target);
+
+	auto* LockOn = ULockOnSubsystem::Get(this);
+	if (!LockOn) return;
+
+	if (Target)
+		LockOn->Register(this, Target);
+	else
+		LockOn->Unregister(this);
+}
+
 void APRCharacter::ApplyCharacterData(const FCharacterData& Data)
 {
 	GetCapsuleComponent()->SetCapsuleSize(Data.CapsuleRadius, Data.CapsuleHalfHeight);
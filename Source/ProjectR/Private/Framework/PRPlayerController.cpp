@@ -2,8 +2,6 @@
 
 #include "Framework/PRPlayerController.h"
 #include "Engine/World.h"
-#include "Perception/AIPerceptionComponent.h"
-#include "Perception/AISenseConfig_Sight.h"
 #include "Component/PRMovementComponent.h"
 #include "Component/TargetComponent.h"
 #include "Component/WeaponComponent.h"
@@ -19,7 +17,6 @@ APRPlayerController::APRPlayerController()
 	bAllowTickBeforeBeginPlay = false;
 
 	Targeter = CreateDefaultSubobject<UTargetComponent>(TEXT("Targeter"));
-	Perception = CreateDefaultSubobject<UAIPerceptionComponent>(TEXT("Perception"));
 }
 
 void APRPlayerController::RegisterInteractor(UObject* InInteractor)
@@ -35,6 +32,13 @@ void APRPlayerController::UnregisterInteractor()
 	OnSetInteractor(Interactor);
 }
 
+void APRPlayerController::ClientReceiveHits_Implementation(const TArray<FHitNotify>& Hits)
+{
+	for (const FHitNotify& Hit : Hits)
+		if (Hit.Target)
+			Hit.Target->OnDamaged.Broadcast(Hit.Damage, Hit.Causer);
+}
+
 FGenericTeamId APRPlayerController::GetGenericTeamId() const
 {
 	if (auto* MyPawn = GetPawn<IGenericTeamAgentInterface>())
@@ -49,43 +53,6 @@ void APRPlayerController::SetGenericTeamId(const FGenericTeamId& NewTeamId)
 		return MyPawn->SetGenericTeamId(NewTeamId);
 }
 
-void APRPlayerController::BeginPlay()
-{
-	Super::BeginPlay();
-
-	Targeter->Initialize(Perception);
-}
-
-void APRPlayerController::Tick(float DeltaSeconds)
-{
-	Super::Tick(DeltaSeconds);
-
-	auto* MyPawn = GetPawn<APRCharacter>();
-	if (!MyPawn || !MyPawn->GetLockedTarget()) return;
-
-	const AActor* LockedTarget = MyPawn->GetLockedTarget();
-	if (Cast<APRCharacter>(LockedTarget)->IsDeath())
-	{
-		Relock();
-		return;
-	}
-
-	float Radius = 0.0f;
-	for (auto Iter = Perception->GetSensesConfigIterator(); Iter; ++Iter)
-	{
-		if (auto* Config = Cast<UAISenseConfig_Sight>(*Iter))
-		{
-			Radius = Config->SightRadius;
-			break;
-		}
-	}
-
-	const FVector TargetLoc = LockedTarget->GetActorLocation();
-	const float Dist = FVector::DistSquared(MyPawn->GetActorLocation(), TargetLoc);
-	if (Dist > FMath::Square(Radius))
-		Relock();
-}
-
 void APRPlayerController::SetupInputComponent()
 {
 	Super::SetupInputComponent();
@@ -231,11 +198,14 @@ void APRPlayerController::Unlock()
 		MyPawn->Unlock();
 }
 
-void APRPlayerController::Relock()
+void APRPlayerController::Relock(AActor* LostTarget)
 {
 	auto* MyPawn = GetPawn<APRCharacter>();
 	if (!MyPawn) return;
 
+	if (LostTarget)
+		Targeter->RemoveCandidate(LostTarget);
+
 	if (AActor* Target = Targeter->GetTargetedActor())
 		MyPawn->Lock(Target);
 	else
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/CombatGrid.h"
+
+FCombatGrid::FCombatGrid(float InCellSize)
+	: CellSize(InCellSize)
+{
+}
+
+void FCombatGrid::Build(const TArray<FVector2D>& Points)
+{
+	const int32 Num = Points.Num();
+
+	TArray<FIntPoint> PointCells;
+	PointCells.SetNumUninitialized(Num);
+	for (int32 Idx = 0; Idx < Num; ++Idx)
+		PointCells[Idx] = GetCell(Points[Idx]);
+
+	Order.SetNumUninitialized(Num);
+	for (int32 Idx = 0; Idx < Num; ++Idx)
+		Order[Idx] = Idx;
+
+	Order.Sort([&PointCells](int32 A, int32 B)
+	{
+		const FIntPoint& CellA = PointCells[A];
+		const FIntPoint& CellB = PointCells[B];
+		return CellA.Y != CellB.Y ? CellA.Y < CellB.Y : CellA.X < CellB.X;
+	});
+
+	Cells.Reset();
+	for (int32 Begin = 0; Begin < Num;)
+	{
+		const FIntPoint Cell = PointCells[Order[Begin]];
+
+		int32 End = Begin + 1;
+		while (End < Num && PointCells[Order[End]] == Cell)
+			++End;
+
+		Cells.Add(Cell, TPair<int32, int32>{ Begin, End });
+		Begin = End;
+	}
+}
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/ComboGraph.h"
+#include "Data/WeaponData.h"
+#include "Skill/Skill.h"
+
+namespace
+{
+	// Index of the shared attack node at the given depth, which is also its skill data index.
+	FORCEINLINE int32 GetCommonNode(int32 Depth, bool bIsStrong) noexcept
+	{
+		return (Depth - 1) * 2 + 1 + (bIsStrong ? 1 : 0);
+	}
+
+	FORCEINLINE int32 GetTreeDepth(int32 TreeIdx) noexcept
+	{
+		return static_cast<int32>(FMath::FloorLog2(static_cast<uint32>(TreeIdx + 1)));
+	}
+}
+
+void FComboGraph::Build(const FWeaponData& Data)
+{
+	Nodes.Reset();
+	WeakRoot = StrongRoot = INDEX_NONE;
+
+	FComboNode& Dodge = Nodes.AddDefaulted_GetRef();
+	Dodge.SkillClass = Data.DodgingClass;
+
+	if (Data.Combo) BuildFromAsset(Data, *Data.Combo);
+	else BuildFromTree(Data);
+}
+
+void FComboGraph::BuildFromTree(const FWeaponData& Data)
+{
+	const int32 Height = Data.ComboHeight;
+
+	// Only overridden tree nodes and their ancestors need their own node.
+	TArray<int32> PathTreeIdx;
+	for (const auto& Skill : Data.Skills)
+	{
+		if (!Skill.Value) continue;
+
+		if (Skill.Key == 0)
+		{
+			Nodes[DodgeNode].SkillClass = Skill.Value;
+			Nodes[DodgeNode].bIsOverrided = true;
+			continue;
+		}
+
+		if (GetTreeDepth(Skill.Key) > Height) continue;
+
+		for (int32 TreeIdx = Skill.Key; TreeIdx > 0; TreeIdx = (TreeIdx - 1) / 2)
+			PathTreeIdx.AddUnique(TreeIdx);
+	}
+
+	PathTreeIdx.Sort();
+
+	const int32 CommonNum = Height * 2;
+	const auto FindNode = [&](int32 TreeIdx)
+	{
+		const int32 PathIdx = PathTreeIdx.Find(TreeIdx);
+		if (PathIdx != INDEX_NONE) return 1 + CommonNum + PathIdx;
+		return GetCommonNode(GetTreeDepth(TreeIdx), (TreeIdx % 2) == 0);
+	};
+
+	for (int32 Depth = 1; Depth <= Height; ++Depth)
+	{
+		for (int32 Strong = 0; Strong < 2; ++Strong)
+		{
+			FComboNode& Node = Nodes.AddDefaulted_GetRef();
+			Node.SkillClass = Data.AttackClass;
+			Node.SkillIndex = GetCommonNode(Depth, Strong != 0);
+
+			if (Depth < Height)
+			{
+				Node.Weak = GetCommonNode(Depth + 1, false);
+				Node.Strong = GetCommonNode(Depth + 1, true);
+			}
+		}
+	}
+
+	for (const int32 TreeIdx : PathTreeIdx)
+	{
+		const int32 Depth = GetTreeDepth(TreeIdx);
+		const auto* Override = Data.Skills.Find(static_cast<uint8>(TreeIdx));
+
+		FComboNode& Node = Nodes.AddDefaulted_GetRef();
+		if (Override && *Override)
+		{
+			Node.SkillClass = *Override;
+			Node.bIsOverrided = true;
+			Node.SkillIndex = TreeIdx;
+		}
+		else
+		{
+			Node.SkillClass = Data.AttackClass;
+			Node.SkillIndex = GetCommonNode(Depth, (TreeIdx % 2) == 0);
+		}
+
+		if (Depth < Height)
+		{
+			Node.Weak = FindNode(TreeIdx * 2 + 1);
+			Node.Strong = FindNode(TreeIdx * 2 + 2);
+		}
+	}
+
+	if (Height > 0)
+	{
+		WeakRoot = FindNode(1);
+		StrongRoot = FindNode(2);
+	}
+}
+
+void FComboGraph::BuildFromAsset(const FWeaponData& Data, const UComboData& Combo)
+{
+	const int32 Num = Combo.Nodes.Num();
+	const auto Remap = [Num](int32 Idx) { return Idx >= 0 && Idx < Num ? Idx + 1 : INDEX_NONE; };
+
+	for (const FComboNode& Authored : Combo.Nodes)
+	{
+		FComboNode& Node = Nodes.Add_GetRef(Authored);
+		if (!Node.SkillClass) Node.SkillClass = Data.AttackClass;
+
+		Node.Weak = Remap(Authored.Weak);
+		Node.Strong = Remap(Authored.Strong);
+	}
+
+	WeakRoot = Remap(Combo.WeakRoot);
+	StrongRoot = Remap(Combo.StrongRoot);
+}
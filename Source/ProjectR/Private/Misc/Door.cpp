@@ -6,6 +6,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "TimerManager.h"
 #include "Framework/PRPlayerController.h"
+#include "Subsystem/GroundSubsystem.h"
 
 ADoor::ADoor()
 	: Super()
@@ -85,6 +86,15 @@ void ADoor::OnCloseTriggerBeginOverlap(AActor* OverlappedActor, AActor* OtherAct
 	if (OtherActor != Player) return;
 	
 	Close();
+
+	// The close trigger spans the arena behind the door, whose ground skills will ask for from now on.
+	if (auto* Ground = UGroundSubsystem::Get(this))
+	{
+		FVector Center, Extent;
+		CloseTrigger->GetActorBounds(false, Center, Extent);
+		Ground->BakeHeightfield(Center, Extent + FVector{ 0.0f, 0.0f, UGroundSubsystem::CellSize });
+	}
+
 	CloseTrigger->Destroy();
 }
 
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/HitboxHistory.h"
+
+void FHitboxHistory::Reset(int32 InCapacity)
+{
+	Capacity = FMath::Max(InCapacity, 1);
+	Head = 0;
+	Num = 0;
+
+	Times.SetNumZeroed(Capacity);
+	QX.SetNumZeroed(Capacity);
+	QY.SetNumZeroed(Capacity);
+	QZ.SetNumZeroed(Capacity);
+}
+
+void FHitboxHistory::Record(float Time, const FVector& Location)
+{
+	if (Capacity == 0) return;
+
+	if (Num == 0)
+		Anchor = Location;
+	else if (((Location - Anchor) / Step).GetAbsMax() > MAX_int16)
+		Rebase(Location);
+
+	const FVector Quantized = (Location - Anchor) / Step;
+
+	Head = (Head + 1) % Capacity;
+	Num = FMath::Min(Num + 1, Capacity);
+
+	Times[Head] = Time;
+	QX[Head] = static_cast<int16>(FMath::RoundToInt(Quantized.X));
+	QY[Head] = static_cast<int16>(FMath::RoundToInt(Quantized.Y));
+	QZ[Head] = static_cast<int16>(FMath::RoundToInt(Quantized.Z));
+}
+
+void FHitboxHistory::Rebase(const FVector& Location)
+{
+	const FVector Offset = (Location - Anchor) / Step;
+	const int32 ShiftX = FMath::RoundToInt(Offset.X);
+	const int32 ShiftY = FMath::RoundToInt(Offset.Y);
+	const int32 ShiftZ = FMath::RoundToInt(Offset.Z);
+	Anchor += FVector(ShiftX, ShiftY, ShiftZ) * Step;
+
+	for (int32 Age = 0; Age < Num; ++Age)
+	{
+		const int32 Slot = GetSlot(Age);
+		const int32 NewX = QX[Slot] - ShiftX;
+		const int32 NewY = QY[Slot] - ShiftY;
+		const int32 NewZ = QZ[Slot] - ShiftZ;
+
+		// Older samples are even further away, such as from before a teleport.
+		if (FMath::Max3(FMath::Abs(NewX), FMath::Abs(NewY), FMath::Abs(NewZ)) > MAX_int16)
+		{
+			Num = Age;
+			break;
+		}
+
+		QX[Slot] = static_cast<int16>(NewX);
+		QY[Slot] = static_cast<int16>(NewY);
+		QZ[Slot] = static_cast<int16>(NewZ);
+	}
+}
+
+bool FHitboxHistory::Sample(float Time, FVector& OutLocation) const
+{
+	if (Num == 0) return false;
+
+	for (int32 Age = 0; Age < Num; ++Age)
+	{
+		const int32 Slot = GetSlot(Age);
+		if (Times[Slot] > Time)
+			continue;
+
+		if (Age == 0)
+		{
+			OutLocation = Dequantize(Slot);
+			return true;
+		}
+
+		const int32 Next = GetSlot(Age - 1);
+		const float Span = Times[Next] - Times[Slot];
+		const float Alpha = Span > KINDA_SMALL_NUMBER ? (Time - Times[Slot]) / Span : 0.0f;
+		OutLocation = FMath::Lerp(Dequantize(Slot), Dequantize(Next), Alpha);
+		return true;
+	}
+
+	OutLocation = Dequantize(GetSlot(Num - 1));
+	return true;
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/RootMotionSource_Leap.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/Character.h"
+#include "Misc/Crc.h"
+#include "Component/PRMovementComponent.h"
+
+FRootMotionSource_Leap::FRootMotionSource_Leap()
+	: Super()
+{
+	Priority = 500;
+	AccumulateMode = ERootMotionAccumulateMode::Override;
+	FinishVelocityParams.Mode = ERootMotionFinishVelocityMode::SetVelocity;
+	FinishVelocityParams.SetVelocity = FVector::ZeroVector;
+	FirstRatio = 0.5f;
+	PathKey = 0u;
+}
+
+void FRootMotionSource_Leap::SetPath(const TArray<FVector>& InPoints, float InFirstRatio)
+{
+	Points = InPoints;
+	FirstRatio = FMath::Clamp(InFirstRatio, 0.0f, 1.0f);
+	PathKey = MakePathKey(Points);
+	Curve.Build(Points, 0.5f);
+}
+
+uint32 FRootMotionSource_Leap::MakePathKey(const TArray<FVector>& InPoints)
+{
+	TArray<FIntVector, TInlineAllocator<8>> Quantized;
+	for (const FVector& Point : InPoints)
+		Quantized.Emplace(FMath::RoundToInt(Point.X * 10.0f), FMath::RoundToInt(Point.Y * 10.0f), FMath::RoundToInt(Point.Z * 10.0f));
+
+	return FCrc::MemCrc32(Quantized.GetData(), Quantized.Num() * Quantized.GetTypeSize());
+}
+
+FVector FRootMotionSource_Leap::GetPathLocation(float Time) const
+{
+	const float FirstTime = Duration * FirstRatio;
+	const float SecondTime = Duration - FirstTime;
+
+	FVector Location = Points.Num() > 1 ? Points[1] : FVector::ZeroVector;
+	if (Time < FirstTime)
+		Curve.ComputeUniform(1, Time / FirstTime, Location);
+	else
+		Curve.ComputeUniform(2, SecondTime > SMALL_NUMBER ? (Time - FirstTime) / SecondTime : 1.0f, Location);
+
+	return Location;
+}
+
+FRootMotionSource* FRootMotionSource_Leap::Clone() const
+{
+	return new FRootMotionSource_Leap{ *this };
+}
+
+bool FRootMotionSource_Leap::Matches(const FRootMotionSource* Other) const
+{
+	if (!Super::Matches(Other))
+		return false;
+
+	const auto* OtherLeap = static_cast<const FRootMotionSource_Leap*>(Other);
+	return PathKey == OtherLeap->PathKey && FMath::IsNearlyEqual(FirstRatio, OtherLeap->FirstRatio);
+}
+
+void FRootMotionSource_Leap::PrepareRootMotion(float SimulationTime, float MovementTickTime,
+	const ACharacter& Character, const UCharacterMovementComponent& MoveComponent)
+{
+	RootMotionParams.Clear();
+
+	// A source received through a root motion update picks up the path the movement component was sent.
+	if (!Curve.IsBuilt())
+		if (const auto* Movement = Cast<UPRMovementComponent>(&MoveComponent))
+			if (Movement->GetLeapPathKey() == PathKey)
+				SetPath(Movement->GetLeapPoints(), FirstRatio);
+
+	if (Duration > SMALL_NUMBER && MovementTickTime > SMALL_NUMBER && Curve.IsBuilt())
+	{
+		const float EndTime = FMath::Min(GetTime() + SimulationTime, Duration);
+		const FVector Velocity = (GetPathLocation(EndTime) - Character.GetActorLocation()) / MovementTickTime;
+		RootMotionParams.Set(FTransform{ Velocity });
+	}
+
+	SetTime(GetTime() + SimulationTime);
+}
+
+bool FRootMotionSource_Leap::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if (!Super::NetSerialize(Ar, Map, bOutSuccess))
+		return false;
+
+	// Sent with every root motion update while the leap lasts, so the points stay behind and only their key goes.
+	const uint32 OldPathKey = PathKey;
+	Ar << FirstRatio;
+	Ar << PathKey;
+
+	if (Ar.IsLoading() && PathKey != OldPathKey)
+	{
+		Points.Reset();
+		Curve = FSplineCurve{};
+	}
+
+	return true;
+}
+
+UScriptStruct* FRootMotionSource_Leap::GetScriptStruct() const
+{
+	return FRootMotionSource_Leap::StaticStruct();
+}
+
+FString FRootMotionSource_Leap::ToSimpleString() const
+{
+	return FString::Printf(TEXT("[ID:%u]FRootMotionSource_Leap %s"), LocalID, *InstanceName.GetPlainNameString());
+}
@@ -3,7 +3,11 @@
 #include "Misc/SkillContext.h"
 #include "Animation/AnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
 #include "GameFramework/Character.h"
+#include "Component/WeaponComponent.h"
+#include "Subsystem/CombatTickSubsystem.h"
+#include "Subsystem/HitboxSubsystem.h"
 
 void USkillContext::Initialize(const TArray<UPrimitiveComponent*>& InComponents)
 {
@@ -13,12 +17,13 @@ void USkillContext::Initialize(const TArray<UPrimitiveComponent*>& InComponents)
 	if (auto* AnimInstance = User->GetMesh()->GetAnimInstance())
 		AnimInstance->OnMontageEnded.AddUniqueDynamic(this, &USkillContext::OnMontageEnded);
 
+	// Hits come from sweeps while an attack window is open, so components never update overlaps.
 	Components = InComponents;
 	for (auto* Component : Components)
-	{
 		Component->SetGenerateOverlapEvents(false);
-		Component->OnComponentBeginOverlap.AddUniqueDynamic(this, &USkillContext::OnOverlap);
-	}
+
+	Traces.SetNumZeroed(Components.Num());
+	EnabledPart = 0;
 }
 
 void USkillContext::SetCollision(int32 AttackPart)
@@ -26,9 +31,22 @@ void USkillContext::SetCollision(int32 AttackPart)
 	const int32 Num = Components.Num();
 	for (int32 Idx = 0; Idx < Num; ++Idx)
 	{
-		const bool bIsEnable = AttackPart & (1 << Idx);
-		Components[Idx]->SetGenerateOverlapEvents(bIsEnable);
+		const int32 Bit = 1 << Idx;
+		if ((AttackPart & Bit) && !(EnabledPart & Bit))
+			BeginTrace(Idx);
 	}
+
+	const bool bWasEnabled = EnabledPart != 0;
+	EnabledPart = AttackPart;
+
+	auto* TickSubsystem = UCombatTickSubsystem::Get(this);
+	if (!TickSubsystem || bWasEnabled == (EnabledPart != 0))
+		return;
+
+	if (bWasEnabled)
+		TickSubsystem->UnregisterContext(this);
+	else
+		TickSubsystem->RegisterContext(this);
 }
 
 void USkillContext::PlayAnimation(UAnimMontage* Animation, const FOnAnimationEnded& OnAnimationEnded)
@@ -47,11 +65,79 @@ void USkillContext::StopAnimation(UAnimMontage* Animation)
 	MulticastStopAnimation(Animation);
 }
 
-void USkillContext::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void USkillContext::TickHit()
+{
+	TArray<AActor*> HitActors;
+	const int32 Num = Components.Num();
+	for (int32 Idx = 0; Idx < Num; ++Idx)
+		if (EnabledPart & (1 << Idx))
+			SweepTrace(Idx, HitActors);
+
+	for (AActor* HitActor : HitActors)
+		OnHit.Broadcast(HitActor);
+}
+
+void USkillContext::BeginTrace(int32 Idx)
 {
-	if (GetTypedOuter<AActor>() != OtherActor)
-		OnHit.Broadcast(OtherActor);
+	// The capsule runs along the longest axis of the component's local bounds.
+	const FBox Box = Components[Idx]->CalcBounds(FTransform::Identity).GetBox();
+	const FVector Extent = Box.GetExtent();
+	const int32 Axis = Extent.X >= Extent.Y ? (Extent.X >= Extent.Z ? 0 : 2) : (Extent.Y >= Extent.Z ? 1 : 2);
+
+	FVector HalfLength = FVector::ZeroVector;
+	HalfLength[Axis] = Extent[Axis];
+
+	FHitTrace& Trace = Traces[Idx];
+	Trace.LocalStart = Box.GetCenter() - HalfLength;
+	Trace.LocalEnd = Box.GetCenter() + HalfLength;
+	Trace.Radius = FMath::Max(FMath::Max(Extent[(Axis + 1) % 3], Extent[(Axis + 2) % 3]), 1.0f);
+	Trace.bHasLast = false;
+}
+
+void USkillContext::GetTraceSegment(int32 Idx, FVector& OutStart, FVector& OutEnd) const
+{
+	const FTransform& Transform = Components[Idx]->GetComponentTransform();
+	OutStart = Transform.TransformPosition(Traces[Idx].LocalStart);
+	OutEnd = Transform.TransformPosition(Traces[Idx].LocalEnd);
+}
+
+void USkillContext::SweepTrace(int32 Idx, TArray<AActor*>& OutActors)
+{
+	FHitTrace& Trace = Traces[Idx];
+
+	FVector Start, End;
+	GetTraceSegment(Idx, Start, End);
+
+	if (!Trace.bHasLast)
+	{
+		Trace.LastStart = Start;
+		Trace.LastEnd = End;
+		Trace.bHasLast = true;
+	}
+
+	// Poses between two frames are interpolated so fast swings cannot skip a target.
+	const float Travel = FMath::Max(FVector::Dist(Start, Trace.LastStart), FVector::Dist(End, Trace.LastEnd));
+	const int32 SubstepNum = FMath::Clamp(FMath::CeilToInt(Travel / Trace.Radius), 1, MaxSubstep);
+
+	auto* Hitboxes = UHitboxSubsystem::Get(this);
+	if (!Hitboxes) return;
+
+	const AActor* User = GetTypedOuter<AActor>();
+	const FGenericTeamId TeamId = FGenericTeamId::GetTeamIdentifier(User);
+	const float RewindTime = Hitboxes->GetRewindTime(Cast<APawn>(User));
+
+	// Sub-step poses are at most one radius apart, so overlapping each of them covers the swept volume.
+	for (int32 Step = 1; Step <= SubstepNum; ++Step)
+	{
+		const float Alpha = static_cast<float>(Step) / SubstepNum;
+		const FVector StepStart = FMath::Lerp(Trace.LastStart, Start, Alpha);
+		const FVector StepEnd = FMath::Lerp(Trace.LastEnd, End, Alpha);
+
+		Hitboxes->OverlapCapsule(StepStart, StepEnd, Trace.Radius, TeamId, User, OutActors, RewindTime);
+	}
+
+	Trace.LastStart = Start;
+	Trace.LastEnd = End;
 }
 
 void USkillContext::OnMontageEnded(UAnimMontage* Montage, bool bInterrupted)
@@ -65,10 +151,18 @@ void USkillContext::OnMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 
 void USkillContext::MulticastPlayAnimation_Implementation(UAnimMontage* Animation)
 {
-	GetTypedOuter<ACharacter>()->PlayAnimMontage(Animation);
+	if (!IsPredictedAnimation(Animation))
+		GetTypedOuter<ACharacter>()->PlayAnimMontage(Animation);
 }
 
 void USkillContext::MulticastStopAnimation_Implementation(UAnimMontage* Animation)
 {
-	GetTypedOuter<ACharacter>()->StopAnimMontage(Animation);
+	if (!IsPredictedAnimation(Animation))
+		GetTypedOuter<ACharacter>()->StopAnimMontage(Animation);
+}
+
+bool USkillContext::IsPredictedAnimation(UAnimMontage* Animation) const
+{
+	const auto* WeaponComponent = GetTypedOuter<UWeaponComponent>();
+	return WeaponComponent && WeaponComponent->IsPredictedAnimation(Animation);
 }
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/SkillPredictionQueue.h"
+
+void FSkillPredictionQueue::Add(UAnimMontage* Montage, uint16 Sequence)
+{
+	Pending.Add(FEntry{ Montage, Sequence });
+	CurrentMontage = Montage;
+	CurrentSequence = Sequence;
+}
+
+bool FSkillPredictionQueue::Confirm(uint16 Sequence, bool bIsAccepted, TArray<UAnimMontage*>& OutRolledBack)
+{
+	const int32 Idx = Pending.IndexOfByPredicate([Sequence](const FEntry& Entry)
+		{ return Entry.Sequence == Sequence; });
+	if (Idx == INDEX_NONE) return false;
+
+	if (bIsAccepted)
+	{
+		Pending.RemoveAt(Idx);
+		return true;
+	}
+
+	for (int32 Later = Idx; Later < Pending.Num(); ++Later)
+		OutRolledBack.Add(Pending[Later].Montage);
+
+	Pending.RemoveAt(Idx, Pending.Num() - Idx);
+	CurrentMontage = nullptr;
+	return true;
+}
+
+bool FSkillPredictionQueue::End(const UAnimMontage* Montage, uint16 Sequence)
+{
+	if (!CurrentMontage || Montage != CurrentMontage || Sequence != CurrentSequence)
+		return false;
+
+	CurrentMontage = nullptr;
+	return true;
+}
+
+bool FSkillPredictionQueue::Contains(const UAnimMontage* Montage) const noexcept
+{
+	return Pending.ContainsByPredicate([Montage](const FEntry& Entry)
+		{ return Entry.Montage == Montage; });
+}
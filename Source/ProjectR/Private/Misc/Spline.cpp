@@ -1,20 +1,190 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Misc/Spline.h"
+#include "Algo/BinarySearch.h"
 
-bool USpline::Compute(int32 Idx, float Alpha, FVector& Point)
+void FSplineCurve::Build(const TArray<FVector>& Points, float Parameterization)
 {
-	if (!IsValidIndex(Idx)) return false;
+	const int32 SegmentNum = FMath::Max(Points.Num() - 3, 0);
+
+	Segments.SetNum(SegmentNum, false);
+	Distances.SetNum(SegmentNum > 0 ? SegmentNum * Resolution + 1 : 0, false);
+	if (SegmentNum == 0) return;
+
+	Distances[0] = 0.0f;
+	FVector Prev = Points[1];
+
+	for (int32 Seg = 0; Seg < SegmentNum; ++Seg)
+	{
+		Segments[Seg] = MakeSegment(Points, Seg + 1, Parameterization);
+
+		for (int32 Sample = 1; Sample <= Resolution; ++Sample)
+		{
+			const FVector Point = Evaluate(Segments[Seg], static_cast<float>(Sample) / Resolution);
+			const int32 Slot = Seg * Resolution + Sample;
+
+			Distances[Slot] = Distances[Slot - 1] + FVector::Dist(Prev, Point);
+			Prev = Point;
+		}
+	}
+}
+
+bool FSplineCurve::ComputeUniform(int32 Idx, float Alpha, FVector& Point) const
+{
+	if (Idx < 1 || Idx > Segments.Num()) return false;
+
+	const float Start = Distances[(Idx - 1) * Resolution];
+	const float End = Distances[Idx * Resolution];
+	return ComputeAtDistance(FMath::Lerp(Start, End, Alpha), Point);
+}
+
+bool FSplineCurve::ComputeAtDistance(float Distance, FVector& Point) const
+{
+	if (Segments.Num() == 0) return false;
+
+	int32 Seg, Upper = 0;
+	float T;
+	FindParameter(Distance, Seg, T, Upper);
+
+	Point = Evaluate(Segments[Seg], T);
+	return true;
+}
+
+void FSplineCurve::ComputeBatch(TArrayView<const float> InDistances, TArrayView<FVector> OutPoints) const
+{
+	check(InDistances.Num() == OutPoints.Num());
+	if (Segments.Num() == 0) return;
+
+	const int32 Num = InDistances.Num();
+	int32 Upper = 0;
+
+	for (int32 Base = 0; Base < Num; Base += 4)
+	{
+		const int32 LaneNum = FMath::Min(Num - Base, 4);
+
+		// Coefficients are gathered per axis, so one register holds the same axis of four samples.
+		MS_ALIGN(16) float Params[4] GCC_ALIGN(16);
+		MS_ALIGN(16) float Lanes[4][3][4] GCC_ALIGN(16);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			int32 Seg = 0;
+			float T = 0.0f;
+			if (Lane < LaneNum)
+				FindParameter(InDistances[Base + Lane], Seg, T, Upper);
+
+			const FSegment& Segment = Segments[Seg];
+			Params[Lane] = T;
+
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				Lanes[0][Axis][Lane] = Segment.A[Axis];
+				Lanes[1][Axis][Lane] = Segment.B[Axis];
+				Lanes[2][Axis][Lane] = Segment.C[Axis];
+				Lanes[3][Axis][Lane] = Segment.D[Axis];
+			}
+		}
+
+		const VectorRegister VT = VectorLoadAligned(Params);
+		MS_ALIGN(16) float Results[3][4] GCC_ALIGN(16);
+
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			VectorRegister Value = VectorMultiplyAdd(VectorLoadAligned(Lanes[0][Axis]), VT, VectorLoadAligned(Lanes[1][Axis]));
+			Value = VectorMultiplyAdd(Value, VT, VectorLoadAligned(Lanes[2][Axis]));
+			Value = VectorMultiplyAdd(Value, VT, VectorLoadAligned(Lanes[3][Axis]));
+			VectorStoreAligned(Value, Results[Axis]);
+		}
+
+		for (int32 Lane = 0; Lane < LaneNum; ++Lane)
+			OutPoints[Base + Lane] = FVector{ Results[0][Lane], Results[1][Lane], Results[2][Lane] };
+	}
+}
+
+FVector FSplineCurve::Compute(const TArray<FVector>& Points, int32 Idx, float Alpha, float Parameterization)
+{
+	return Evaluate(MakeSegment(Points, Idx, Parameterization), Alpha);
+}
 
+void FSplineCurve::FindParameter(float Distance, int32& OutSegment, float& OutT, int32& InOutUpper) const
+{
+	const int32 Last = Distances.Num() - 1;
+	Distance = FMath::Clamp(Distance, 0.0f, Distances[Last]);
+
+	int32 Upper = InOutUpper;
+	if (Upper >= 1 && Upper <= Last && Distances[Upper - 1] <= Distance)
+	{
+		while (Upper < Last && Distances[Upper] <= Distance)
+			++Upper;
+	}
+	else
+	{
+		Upper = FMath::Clamp(Algo::UpperBound(Distances, Distance), 1, Last);
+	}
+
+	InOutUpper = Upper;
+	const int32 Lower = Upper - 1;
+
+	const float Span = Distances[Upper] - Distances[Lower];
+	const float Ratio = Span > KINDA_SMALL_NUMBER ? (Distance - Distances[Lower]) / Span : 0.0f;
+
+	OutSegment = Lower / Resolution;
+	OutT = (Lower % Resolution + Ratio) / Resolution;
+}
+
+FSplineCurve::FSegment FSplineCurve::MakeSegment(const TArray<FVector>& Points, int32 Idx, float Parameterization)
+{
 	const FVector& P0 = Points[Idx - 1];
 	const FVector& P1 = Points[Idx];
 	const FVector& P2 = Points[Idx + 1];
 	const FVector& P3 = Points[Idx + 2];
 
-	Point = 0.5f * ((2.0f * P1) + (-P0 + P2) * Alpha +
-		(2.0f * P0 - 5.0f * P1 + 4.0f * P2 - P3) * Alpha * Alpha +
-		(-P0 + 3.0f * P1 - 3.0f * P2 + P3) * Alpha * Alpha * Alpha);
+	// Knot intervals of the non-uniform parameterization, kept away from zero for repeated points.
+	const auto Knot = [Parameterization](const FVector& From, const FVector& To)
+	{
+		return FMath::Max(FMath::Pow(FVector::DistSquared(From, To), Parameterization * 0.5f), KINDA_SMALL_NUMBER);
+	};
+
+	const float T01 = Knot(P0, P1);
+	const float T12 = Knot(P1, P2);
+	const float T23 = Knot(P2, P3);
+
+	// Tangents scaled to the segment's interval, then written as a Hermite cubic on [0, 1].
+	const FVector M1 = T12 * ((P1 - P0) / T01 - (P2 - P0) / (T01 + T12) + (P2 - P1) / T12);
+	const FVector M2 = T12 * ((P2 - P1) / T12 - (P3 - P1) / (T12 + T23) + (P3 - P2) / T23);
+
+	FSegment Segment;
+	Segment.A = FVector4{ 2.0f * (P1 - P2) + M1 + M2, 0.0f };
+	Segment.B = FVector4{ 3.0f * (P2 - P1) - 2.0f * M1 - M2, 0.0f };
+	Segment.C = FVector4{ M1, 0.0f };
+	Segment.D = FVector4{ P1, 0.0f };
+	return Segment;
+}
+
+FVector FSplineCurve::Evaluate(const FSegment& Segment, float T)
+{
+	const VectorRegister VT = VectorSetFloat1(T);
+
+	VectorRegister Point = VectorMultiplyAdd(VectorLoad(&Segment.A), VT, VectorLoad(&Segment.B));
+	Point = VectorMultiplyAdd(Point, VT, VectorLoad(&Segment.C));
+	Point = VectorMultiplyAdd(Point, VT, VectorLoad(&Segment.D));
+
+	FVector Result;
+	VectorStoreFloat3(Point, &Result);
+	return Result;
+}
 
+USpline::USpline()
+	: Super()
+{
+	Parameterization = 0.5f;
+}
+
+bool USpline::Compute(int32 Idx, float Alpha, FVector& Point)
+{
+	if (!IsValidIndex(Idx)) return false;
+
+	Point = FSplineCurve::Compute(Points, Idx, Alpha, Parameterization);
 	return true;
 }
 
@@ -22,3 +192,18 @@ bool USpline::IsValidIndex(int32 Idx)
 {
 	return Idx != 0 && Idx + 2 < Points.Num();
 }
+
+void USpline::Build()
+{
+	Curve.Build(Points, Parameterization);
+}
+
+bool USpline::ComputeUniform(int32 Idx, float Alpha, FVector& Point) const
+{
+	return Curve.ComputeUniform(Idx, Alpha, Point);
+}
+
+bool USpline::ComputeAtDistance(float Distance, FVector& Point) const
+{
+	return Curve.ComputeAtDistance(Distance, Point);
+}
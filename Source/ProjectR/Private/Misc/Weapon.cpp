@@ -6,241 +6,84 @@
 #include "Animation/BlendSpace1D.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Engine/StaticMesh.h"
-#include "UObject/ConstructorHelpers.h"
-#include "Component/WeaponComponent.h"
-#include "Framework/PRCharacter.h"
-#include "Data/SkillData.h"
 #include "Data/WeaponData.h"
-#include "Interface/Executable.h"
-#include "Interface/StateExecutable.h"
 #include "Library/PRStatics.h"
 #include "Skill/Skill.h"
 
-UWeapon::UWeapon()
-	: Super()
+void UWeapon::Initialize(uint8 InKey, const FWeaponData& Data, const FComboGraph& Graph)
 {
-	static ConstructorHelpers::FObjectFinder<UDataTable> WeaponDataTableFinder(TEXT("DataTable'/Game/Data/DataTable/DT_WeaponData.DT_WeaponData'"));
-	WeaponDataTable = WeaponDataTableFinder.Object;
-
-	static ConstructorHelpers::FObjectFinder<UDataTable> SkillDataTableFinder(TEXT("DataTable'/Game/Data/DataTable/DT_SkillData.DT_SkillData'"));
-	SkillDataTable = SkillDataTableFinder.Object;
-}
-
-bool UWeapon::Initialize(USkillContext* InContext, uint8 InKey)
-{
-	if (InKey == 255u) return false;
-
-	Context = InContext;
 	Key = InKey;
+	ComboGraph = Graph;
 
-	User = GetTypedOuter<APRCharacter>();
-	if (!User)
-	{
-		Key = 255u;
-		return false;
-	}
-
-	if (!WeaponDataTable)
-	{
-		Key = 255u;
-		return false;
-	}
-
-	const auto* Data = WeaponDataTable->FindRow<FWeaponData>(FName{ *FString::FromInt(Key) }, TEXT(""), false);
-	if (!Data)
-	{
-		UE_LOG(LogDataTable, Error, TEXT("Cannot found weapon data %d!"), Key);
-		Key = 255u;
-		return false;
-	}
-
-	int32 SkillNum = 1;
-	for (uint8 Idx = 1u; Idx <= Data->ComboHeight; ++Idx)
-		SkillNum += static_cast<int32>(FMath::Pow(2, Idx));
-
-	Skills.Init(FUsableSkill{}, SkillNum);
-
-	if (Data->DodgingClass)
-	{
-		USkill* Dodge = NewObject<USkill>(this, Data->DodgingClass);
-		Dodge->Initialize();
-		Skills[0].Skill = Dodge;
-	}
-
-	if (Data->AttackClass)
-	{
-		USkill* Attack = NewObject<USkill>(this, Data->AttackClass);
-		Attack->Initialize();
-
-		for (int32 Index = 1; Index < SkillNum; ++Index)
-			Skills[Index].Skill = Attack;
-	}
-
-	for (const auto& Skill : Data->Skills)
-	{
-		if (Skill.Value)
-		{
-			USkill* SkillInst = NewObject<USkill>(this, Skill.Value);
-			SkillInst->Initialize();
-			Skills[Skill.Key].Skill = SkillInst;
-			Skills[Skill.Key].bIsOverrided = true;
-		}
-	}
-
-	VisualData.RightAnim = Data->RightAnim;
-	VisualData.RightTransform = Data->RightTransform;
+	VisualData.RightAnim = Data.RightAnim;
+	VisualData.RightTransform = Data.RightTransform;
 
-	VisualData.LeftAnim = Data->LeftAnim;
-	VisualData.LeftTransform = Data->LeftTransform;
+	VisualData.LeftAnim = Data.LeftAnim;
+	VisualData.LeftTransform = Data.LeftTransform;
 
-	LoadAll(*Data);
-	return true;
+	Load(Data);
 }
 
-void UWeapon::InitSkill(uint8 Level)
+void UWeapon::RegisterOnAsyncLoadEnded(const FOnAsyncLoadEndedSingle& Callback)
 {
-	if (Key == 255u || !SkillDataTable) return;
-
-	const FString BaseKey = FString::FromInt(Key) + FString::FromInt(Level);
-	const int32 SkillNum = Skills.Num();
-	for (int32 Idx = 0; Idx < SkillNum; ++Idx)
-	{
-		FUsableSkill& Skill = Skills[Idx];
-		if (!Skill.Skill) continue;
-
-		const int32 Prefix = Skill.bIsOverrided ? 1 : 0;
-		int32 SkillIdx = Idx;
-		if (Prefix == 0 && Idx != 0)
-		{
-			SkillIdx = (static_cast<int32>(FMath::Log2(Idx + 1)) - 1) * 2 + 1;
-			if ((Idx % 2) == 0) ++SkillIdx;
-		}
-
-		const FName SkillKey{ *(BaseKey + FString::FromInt(Prefix) + FString::FromInt(SkillIdx)) };
-		const auto* Data = SkillDataTable->FindRow<FSkillData>(SkillKey, TEXT(""), false);
-		if (!Data)
-		{
-			UE_LOG(LogDataTable, Error, TEXT("Cannot found skill data %s!"), *SkillKey.ToString());
-			continue;
-		}
-
-		Skill.Data = Data->Data;
-	}
+	check(Callback.IsBound());
+	if (bIsLoaded) Callback.Execute();
+	else OnAsyncLoadEnded.Add(Callback);
 }
 
-void UWeapon::BeginSkill(uint8 Index)
+void UWeapon::Load(const FWeaponData& WeaponData)
 {
-	if (!Skills.IsValidIndex(Index))
+	if (bIsLoadRequested) return;
+	bIsLoadRequested = true;
+
+	TArray<FSoftObjectPath> Paths;
+	Paths.Add(WeaponData.RightMesh.ToSoftObjectPath());
+	Paths.Add(WeaponData.LeftMesh.ToSoftObjectPath());
+	Paths.Add(WeaponData.NotLockAnim.ToSoftObjectPath());
+	Paths.Add(WeaponData.LockAnim.ToSoftObjectPath());
+	Paths.Add(WeaponData.AirAnim.ToSoftObjectPath());
+
+	LoadHandle = UPRStatics::AsyncLoadMany(this, MoveTemp(Paths), [this, RightMesh = WeaponData.RightMesh,
+		LeftMesh = WeaponData.LeftMesh, NotLock = WeaponData.NotLockAnim, Lock = WeaponData.LockAnim, Air = WeaponData.AirAnim]
 	{
-		User->GetWeaponComponent()->OnEndSkill();
-		return;
-	}
-
-	FUsableSkill& Skill = Skills[Index];
-	if (Skill.Skill && Skill.Skill->CanUseSkill())
-		Skill.Skill->Begin(Context, Skill.Data);
-	else 
-		User->GetWeaponComponent()->OnEndSkill();
-}
-
-void UWeapon::EndSkill(uint8 Index)
-{
-	if (!Skills.IsValidIndex(Index))
-		return;
-	
-	FUsableSkill& Skill = Skills[Index];
-	if (Skill.Skill) Skill.Skill->End();
-}
-
-void UWeapon::TickSkill(uint8 Index, float DeltaTime)
-{
-	if (!Skills.IsValidIndex(Index))
-		return;
-
-	FUsableSkill& Skill = Skills[Index];
-	if (Skill.Skill) Skill.Skill->Tick(DeltaTime);
-}
-
-void UWeapon::RegisterOnAsyncLoadEnded(const FOnAsyncLoadEndedSingle& Callback)
-{
-	check(Callback.IsBound());
-	if (AsyncLoadCount) OnAsyncLoadEnded.Add(Callback);
-	else Callback.Execute();
+		VisualData.RightMesh = RightMesh.Get();
+		VisualData.LeftMesh = LeftMesh.Get();
+		VisualData.AnimData.NotLock = NotLock.Get();
+		VisualData.AnimData.Lock = Lock.Get();
+		VisualData.AnimData.Air = Air.Get();
+		BroadcastAsyncLoadEnded();
+	});
 }
 
-void UWeapon::Execute(uint8 Index)
+void UWeapon::Unload()
 {
-	if (!Skills.IsValidIndex(Index)) return;
+	if (!bIsLoadRequested) return;
 
-	USkill* Skill = Skills[Index].Skill;
-	if (Skill && Skill->GetClass()->ImplementsInterface(UExecutable::StaticClass()))
-		return IExecutable::Execute_Execute(Skill);
-}
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->CancelHandle();
+		LoadHandle.Reset();
+	}
 
-void UWeapon::BeginExecute(uint8 Index)
-{
-	if (!Skills.IsValidIndex(Index)) return;
+	VisualData.RightMesh = nullptr;
+	VisualData.LeftMesh = nullptr;
+	VisualData.AnimData = FAnimData{};
 
-	USkill* Skill = Skills[Index].Skill;
-	if (Skill && Skill->GetClass()->ImplementsInterface(UStateExecutable::StaticClass()))
-		return IStateExecutable::Execute_BeginExecute(Skill);
+	bIsLoaded = false;
+	bIsLoadRequested = false;
 }
 
-void UWeapon::EndExecute(uint8 Index)
+void UWeapon::BroadcastAsyncLoadEnded()
 {
-	if (!Skills.IsValidIndex(Index)) return;
-
-	USkill* Skill = Skills[Index].Skill;
-	if (Skill && Skill->GetClass()->ImplementsInterface(UStateExecutable::StaticClass()))
-		return IStateExecutable::Execute_EndExecute(Skill);
+	bIsLoaded = true;
+	OnAsyncLoadEnded.Broadcast();
+	OnAsyncLoadEnded.Clear();
 }
 
-void UWeapon::LoadAll(const FWeaponData& WeaponData)
+void UWeapon::BeginDestroy()
 {
-	if (!WeaponData.RightMesh.IsNull()) ++AsyncLoadCount;
-	if (!WeaponData.LeftMesh.IsNull()) ++AsyncLoadCount;
-	if (!WeaponData.NotLockAnim.IsNull()) ++AsyncLoadCount;
-	if (!WeaponData.LockAnim.IsNull()) ++AsyncLoadCount;
-	if (!WeaponData.AirAnim.IsNull()) ++AsyncLoadCount;
+	if (LoadHandle.IsValid())
+		LoadHandle->CancelHandle();
 
-	if (AsyncLoadCount == 0u)
-	{
-		OnAsyncLoadEnded.Broadcast();
-		return;
-	}
-
-	UPRStatics::AsyncLoad(WeaponData.RightMesh, [this, &RightMeshPtr = WeaponData.RightMesh]
-	{
-		VisualData.RightMesh = RightMeshPtr.Get();
-		if (--AsyncLoadCount == 0u)
-			OnAsyncLoadEnded.Broadcast();
-	});
-
-	UPRStatics::AsyncLoad(WeaponData.LeftMesh, [this, &LeftMeshPtr = WeaponData.LeftMesh]
-	{
-		VisualData.LeftMesh = LeftMeshPtr.Get();
-		if (--AsyncLoadCount == 0u)
-			OnAsyncLoadEnded.Broadcast();
-	});
-
-	UPRStatics::AsyncLoad(WeaponData.NotLockAnim, [this, &NotLockPtr = WeaponData.NotLockAnim]
-	{
-		VisualData.AnimData.NotLock = NotLockPtr.Get();
-		if (--AsyncLoadCount == 0u)
-			OnAsyncLoadEnded.Broadcast();
-	});
-
-	UPRStatics::AsyncLoad(WeaponData.LockAnim, [this, &LockPtr = WeaponData.LockAnim]
-	{
-		VisualData.AnimData.Lock = LockPtr.Get();
-		if (--AsyncLoadCount == 0u)
-			OnAsyncLoadEnded.Broadcast();
-	});
-
-	UPRStatics::AsyncLoad(WeaponData.AirAnim, [this, &AirPtr = WeaponData.AirAnim]
-	{
-		VisualData.AnimData.Air = AirPtr.Get();
-		if (--AsyncLoadCount == 0u)
-			OnAsyncLoadEnded.Broadcast();
-	});
+	Super::BeginDestroy();
 }
@@ -2,137 +2,76 @@
 
 #include "Skill/Leap.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
+#include "Component/PRMovementComponent.h"
 #include "Data/LeapData.h"
 #include "Framework/PRCharacter.h"
-#include "Misc/Spline.h"
+#include "Subsystem/GroundSubsystem.h"
 
-ULeap::ULeap()
-	: Super()
+void ULeap::Begin(USkillContext* InContext, const UDataAsset* Data)
 {
-	Spline = CreateDefaultSubobject<USpline>(TEXT("Spline"));
-	Spline->GetPoints().Init(FVector::ZeroVector, 5);
+	Super::Begin(InContext, Data);
+	StartLeap(GetUser(), Data);
 }
 
-void ULeap::Initialize()
+void ULeap::End()
 {
-	Super::Initialize();
-
-	const float ActorZ = GetUser()->GetActorLocation().Z;
-	const float RootZ = GetUser()->GetMesh()->GetBoneLocation(TEXT("root")).Z;
-	RootHeight = ActorZ - RootZ;
+	StopLeap(GetUser());
+	Super::End();
 }
 
-void ULeap::Begin(USkillContext* InContext, const UDataAsset* Data)
+void ULeap::BeginPrediction(APRCharacter* InUser, const UDataAsset* Data) const
 {
-	Super::Begin(InContext, Data);
-
-	SetData(Data);
-	InitSpline();
-
-	GetUser()->GetCharacterMovement()
-		->SetMovementMode(EMovementMode::MOVE_Flying);
+	StartLeap(InUser, Data);
 }
 
-void ULeap::Tick(float DeltaTime)
+void ULeap::EndPrediction(APRCharacter* InUser) const
 {
-	Super::Tick(DeltaTime);
-
-	if (bIsLeapEnded) return;
-
-	if (Idx == 1)
-		UpdateSpline();
-	
-	UpdateLeap(DeltaTime);
-	
-	FVector NewLocation;
-	if (Spline->Compute(Idx, Alpha, NewLocation))
-	{
-		NewLocation.Z += RootHeight;
-		if (!GetUser()->SetActorLocation(NewLocation, true))
-			bIsLeapEnded = true;
-	}
-	else bIsLeapEnded = true;
+	StopLeap(InUser);
 }
 
-void ULeap::End()
+void ULeap::StartLeap(APRCharacter* InUser, const UDataAsset* Data)
 {
-	GetUser()->GetCharacterMovement()
-		->SetMovementMode(EMovementMode::MOVE_Walking);
+	const auto* MyData = Cast<const ULeapData>(Data);
+	auto* Movement = Cast<UPRMovementComponent>(InUser->GetCharacterMovement());
+	if (!MyData || !Movement || !InUser->GetLockedTarget())
+		return;
 
-	Super::End();
+	TArray<FVector> Points;
+	BuildPath(InUser, *MyData, Points);
+	Movement->StartLeap(Points, MyData->LeapDuration, MyData->LeapTimeRatio);
 }
 
-void ULeap::SetData(const UDataAsset* Data)
+void ULeap::StopLeap(APRCharacter* InUser)
 {
-	const auto* MyData = Cast<const ULeapData>(Data);
-	MaxHeight = MyData->MaxHeight;
-	LeapDuration = MyData->LeapDuration;
-	AttackRange = MyData->AttackRange;
-	MaxHeightRatio = MyData->MaxHeightRatio;
-	LeapTimeRatio = MyData->LeapTimeRatio;
+	if (auto* Movement = Cast<UPRMovementComponent>(InUser->GetCharacterMovement()))
+		Movement->StopLeap();
 }
 
-void ULeap::InitSpline()
+void ULeap::BuildPath(const APRCharacter* InUser, const ULeapData& Data, TArray<FVector>& OutPoints)
 {
-	StartLocation = GetUser()->GetMesh()->GetBoneLocation(TEXT("root"));
-	Target = GetUser()->GetLockedTarget();
-
-	FVector RangeVec = Target->GetActorLocation() - StartLocation;
-	RangeVec.Z = 0.0f;
-	RangeVec.Normalize();
-	RangeVec *= AttackRange;
-
-	Spline->GetPoints()[0] = StartLocation - RangeVec;
-	Spline->GetPoints()[1] = StartLocation;
+	const FVector StartLocation = InUser->GetMesh()->GetBoneLocation(TEXT("root"));
+	const float RootHeight = InUser->GetActorLocation().Z - StartLocation.Z;
+	const AActor* Target = InUser->GetLockedTarget();
 
-	Idx = 1;
-	Alpha = 0.0f;
-	bIsLeapEnded = false;
-}
-
-void ULeap::UpdateSpline()
-{
+	// The path is fixed when the leap starts, landing on the ground below where the target is right now.
 	FVector TargetLocation = Target->GetActorLocation();
-	FVector UnderLocation = TargetLocation;
-	UnderLocation.Z = -1000.0f;
+	auto* Ground = UGroundSubsystem::Get(InUser);
 
-	FCollisionObjectQueryParams Params;
-	Params.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldStatic);
-
-	FHitResult Result;
-	if (GetWorld()->LineTraceSingleByObjectType(Result, TargetLocation, UnderLocation, Params))
-		TargetLocation.Z = Result.Location.Z;
-
-	auto& Point2 = Spline->GetPoints()[2];
-	Point2 = FMath::Lerp(StartLocation, TargetLocation, MaxHeightRatio);
-	Point2.Z += MaxHeight;
+	float GroundHeight;
+	if (Ground && Ground->GetGroundHeight(Target, GroundHeight))
+		TargetLocation.Z = GroundHeight;
+	else
+		TargetLocation.Z -= Target->GetSimpleCollisionHalfHeight();
 
 	FVector RangeVec = TargetLocation - StartLocation;
 	RangeVec.Z = 0.0f;
-	RangeVec.Normalize();
-	RangeVec *= AttackRange;
+	RangeVec = RangeVec.GetSafeNormal() * Data.AttackRange;
 
-	Spline->GetPoints()[3] = TargetLocation - RangeVec;
-	Spline->GetPoints()[4] = TargetLocation;
-}
+	FVector Peak = FMath::Lerp(StartLocation, TargetLocation, Data.MaxHeightRatio);
+	Peak.Z += Data.MaxHeight;
 
-void ULeap::UpdateLeap(float DeltaTime)
-{
-	float TimeRatio = Idx == 1 ? LeapTimeRatio : (1.0f - LeapTimeRatio);
-	TimeRatio *= LeapDuration;
-
-	Alpha += DeltaTime / TimeRatio;
-	if (Alpha <= 1.0f) return;
+	OutPoints = { StartLocation - RangeVec, StartLocation, Peak, TargetLocation - RangeVec, TargetLocation };
 
-	if (Idx == 1)
-	{
-		Idx = 2;
-		Alpha = FMath::Fmod(Alpha, 1.0f);
-	}
-	else
-	{
-		Alpha = 1.0f;
-		bIsLeapEnded = true;
-	}
+	for (FVector& Point : OutPoints)
+		Point.Z += RootHeight;
 }
@@ -5,6 +5,7 @@
 #include "Data/SingleAttackData.h"
 #include "Framework/PRCharacter.h"
 #include "Misc/SkillContext.h"
+#include "Subsystem/DamageSubsystem.h"
 
 void USingleAttack::Begin(USkillContext* InContext, const UDataAsset* Data)
 {
@@ -41,6 +42,7 @@ void USingleAttack::End()
 	}
 
 	Context->OnHit.RemoveDynamic(this, &USingleAttack::OnHit);
+	Context->SetCollision(0);
 	Context->StopAnimation(Animation);
 
 	Super::End();
@@ -51,6 +53,15 @@ bool USingleAttack::CanUseSkill_Implementation() const
 	return !GetUser()->GetCharacterMovement()->IsFalling();
 }
 
+UAnimMontage* USingleAttack::GetPredictedAnimation(const APRCharacter* InUser, const UDataAsset* Data) const
+{
+	const auto* MyData = Cast<const USingleAttackData>(Data);
+	if (!MyData || MyData->AttackPart == 0 || InUser->GetCharacterMovement()->IsFalling())
+		return nullptr;
+
+	return MyData->Animation;
+}
+
 void USingleAttack::BeginExecute_Implementation()
 {
 	Context->SetCollision(AttackPart);
@@ -79,8 +90,8 @@ void USingleAttack::OnHit(AActor* Target)
 	if (AttackedActors.Contains(Target)) return;
 
 	AttackedActors.Add(Target);
-	Target->TakeDamage(Damage, FDamageEvent{},
-		GetUser()->GetController(), GetUser());
+	if (auto* Damages = UDamageSubsystem::Get(this))
+		Damages->QueueDamage(Target, Damage, GetUser()->GetController(), GetUser());
 }
 
 void USingleAttack::OnAnimationEnded()
@@ -7,6 +7,10 @@
 void USkill::Initialize()
 {
 	User = GetTypedOuter<APRCharacter>();
+
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(USkill, ReceiveTick)))
+		bCanEverTick = true;
+
 	ReceiveInitialize();
 }
 
@@ -26,6 +30,11 @@ void USkill::End()
 	User->GetWeaponComponent()->OnEndSkill();
 }
 
+UAnimMontage* USkill::GetPredictedAnimation(const APRCharacter* InUser, const UDataAsset* Data) const
+{
+	return nullptr;
+}
+
 void USkill::Finish()
 {
 	End();
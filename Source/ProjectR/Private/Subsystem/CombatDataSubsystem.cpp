@@ -0,0 +1,324 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/CombatDataSubsystem.h"
+#include "Engine/DataTable.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+#include "UObject/ConstructorHelpers.h"
+#include "Data/CharacterData.h"
+#include "Data/SkillData.h"
+#include "Data/WeaponData.h"
+#include "Misc/Weapon.h"
+
+UCombatDataSubsystem::UCombatDataSubsystem()
+	: Super()
+{
+	static ConstructorHelpers::FObjectFinder<UDataTable> CharacterDataTableFinder(TEXT("DataTable'/Game/Data/DataTable/DT_CharacterData.DT_CharacterData'"));
+	CharacterDataTable = CharacterDataTableFinder.Object;
+
+	static ConstructorHelpers::FObjectFinder<UDataTable> WeaponDataTableFinder(TEXT("DataTable'/Game/Data/DataTable/DT_WeaponData.DT_WeaponData'"));
+	WeaponDataTable = WeaponDataTableFinder.Object;
+
+	static ConstructorHelpers::FObjectFinder<UDataTable> SkillDataTableFinder(TEXT("DataTable'/Game/Data/DataTable/DT_SkillData.DT_SkillData'"));
+	SkillDataTable = SkillDataTableFinder.Object;
+
+	bIsLoaded = false;
+}
+
+UCombatDataSubsystem* UCombatDataSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr)
+		return GameInstance->GetSubsystem<UCombatDataSubsystem>();
+
+#if WITH_EDITOR
+	// Editor worlds have no game instance, so previews read from the class default object.
+	auto* Default = GetMutableDefault<UCombatDataSubsystem>();
+	Default->Load();
+	return Default;
+#else
+	return nullptr;
+#endif
+}
+
+const FCharacterData* UCombatDataSubsystem::FindCharacterData(uint8 Key) const
+{
+	return Characters.IsValidIndex(Key) ? Characters[Key] : nullptr;
+}
+
+const FWeaponData* UCombatDataSubsystem::FindWeaponData(uint8 Key) const
+{
+	return Weapons.IsValidIndex(Key) ? Weapons[Key].Data : nullptr;
+}
+
+UDataAsset* UCombatDataSubsystem::FindSkillData(uint8 WeaponKey,
+	uint8 Level, bool bIsOverrided, int32 SkillIdx) const
+{
+	if (!Weapons.IsValidIndex(WeaponKey) || Level >= MaxLevel)
+		return nullptr;
+
+	const FWeaponEntry& Entry = Weapons[WeaponKey];
+	const int32 RangeNum = bIsOverrided ? Entry.SlotNum - Entry.CommonSlotNum : Entry.CommonSlotNum;
+	if (SkillIdx < 0 || SkillIdx >= RangeNum)
+		return nullptr;
+
+	const int32 Slot = bIsOverrided ? Entry.CommonSlotNum + SkillIdx : SkillIdx;
+	return Entry.SkillData[Level * Entry.SlotNum + Slot];
+}
+
+const TArray<UDataAsset*>* UCombatDataSubsystem::ResolveSkills(uint8 WeaponKey, uint8 Level)
+{
+	if (!Weapons.IsValidIndex(WeaponKey) || !Weapons[WeaponKey].Data || Level >= MaxLevel)
+		return nullptr;
+
+	FWeaponEntry& Entry = Weapons[WeaponKey];
+	const auto& Nodes = Entry.Graph.GetNodes();
+	const int32 NodeNum = Nodes.Num();
+
+	TArray<UDataAsset*>& Resolved = Entry.ResolvedSkills[Level];
+	if (Resolved.Num() == NodeNum)
+		return &Resolved;
+
+	Resolved.SetNumZeroed(NodeNum);
+	for (int32 Idx = 0; Idx < NodeNum; ++Idx)
+		Resolved[Idx] = FindSkillData(WeaponKey, Level, Nodes[Idx].bIsOverrided, Nodes[Idx].SkillIndex);
+
+	return &Resolved;
+}
+
+UWeapon* UCombatDataSubsystem::GetWeapon(uint8 Key)
+{
+	const FWeaponData* Data = FindWeaponData(Key);
+	if (!Data) return nullptr;
+
+	if (WeaponArchetypes.Num() <= Key)
+		WeaponArchetypes.SetNumZeroed(Weapons.Num());
+
+	UWeapon*& Weapon = WeaponArchetypes[Key];
+	if (!Weapon)
+	{
+		Weapon = NewObject<UWeapon>(this);
+		Weapon->Initialize(Key, *Data, Weapons[Key].Graph);
+	}
+	else if (!Weapon->IsLoadRequested())
+	{
+		Weapon->Load(*Data);
+	}
+
+	return Weapon;
+}
+
+void UCombatDataSubsystem::RegisterLoadout(const AActor* Owner, const TArray<uint8>& Keies, uint8 EquippedKey)
+{
+	FLoadout* Loadout = Loadouts.FindByPredicate([Owner](const FLoadout& Other) { return Other.Owner == Owner; });
+	if (!Loadout)
+	{
+		Loadout = &Loadouts.AddDefaulted_GetRef();
+		Loadout->Owner = Owner;
+	}
+
+	Loadout->Keies = Keies;
+	Loadout->EquippedKey = EquippedKey;
+
+	FTimerManager& TimerManager = GetGameInstance()->GetTimerManager();
+	if (!TimerManager.IsTimerActive(PrefetchTimer))
+	{
+		TimerManager.SetTimer(PrefetchTimer, this, &UCombatDataSubsystem::UpdatePrefetch, PrefetchInterval, true);
+		TimerManager.SetTimerForNextTick(this, &UCombatDataSubsystem::UpdatePrefetch);
+	}
+}
+
+void UCombatDataSubsystem::UnregisterLoadout(const AActor* Owner)
+{
+	Loadouts.RemoveAllSwap([Owner](const FLoadout& Loadout) { return Loadout.Owner == Owner; });
+	if (Loadouts.Num() == 0)
+		GetGameInstance()->GetTimerManager().ClearTimer(PrefetchTimer);
+}
+
+void UCombatDataSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Load();
+}
+
+void UCombatDataSubsystem::Deinitialize()
+{
+	GetGameInstance()->GetTimerManager().ClearTimer(PrefetchTimer);
+	Loadouts.Empty();
+	Characters.Empty();
+	Weapons.Empty();
+	WeaponArchetypes.Empty();
+	bIsLoaded = false;
+
+	Super::Deinitialize();
+}
+
+void UCombatDataSubsystem::Load()
+{
+	if (bIsLoaded) return;
+	bIsLoaded = true;
+
+	Report = FCombatDataReport{};
+
+	LoadCharacterData();
+	LoadWeaponData();
+
+	if (Report.MissingRows.Num() > 0 || Report.InvalidRows.Num() > 0)
+	{
+		UE_LOG(LogDataTable, Warning, TEXT("Combat data has %d missing and %d invalid rows."),
+			Report.MissingRows.Num(), Report.InvalidRows.Num());
+	}
+}
+
+void UCombatDataSubsystem::LoadCharacterData()
+{
+	Characters.Empty();
+	if (!CharacterDataTable) return;
+
+	for (const auto& Row : CharacterDataTable->GetRowMap())
+	{
+		uint8 Key;
+		if (!ParseKey(Row.Key, Key)) continue;
+
+		if (Characters.Num() <= Key)
+			Characters.SetNumZeroed(Key + 1);
+
+		Characters[Key] = reinterpret_cast<const FCharacterData*>(Row.Value);
+	}
+}
+
+void UCombatDataSubsystem::LoadWeaponData()
+{
+	Weapons.Empty();
+	if (!WeaponDataTable) return;
+
+	for (const auto& Row : WeaponDataTable->GetRowMap())
+	{
+		uint8 Key;
+		if (!ParseKey(Row.Key, Key)) continue;
+
+		if (Weapons.Num() <= Key)
+			Weapons.SetNum(Key + 1);
+
+		Weapons[Key].Data = reinterpret_cast<const FWeaponData*>(Row.Value);
+	}
+
+	const int32 WeaponNum = Weapons.Num();
+	for (int32 Key = 0; Key < WeaponNum; ++Key)
+		if (Weapons[Key].Data)
+			LoadSkillData(static_cast<uint8>(Key), Weapons[Key]);
+}
+
+void UCombatDataSubsystem::LoadSkillData(uint8 WeaponKey, FWeaponEntry& Entry)
+{
+	Entry.Graph.Build(*Entry.Data);
+	const auto& Nodes = Entry.Graph.GetNodes();
+
+	if (!Entry.Data->Combo)
+	{
+		const uint8 Height = Entry.Data->ComboHeight;
+		const int32 TreeNum = Height < 8u ? (1 << (Height + 1)) - 1 : 256;
+		for (const auto& Skill : Entry.Data->Skills)
+			if (Skill.Key >= TreeNum)
+				Report.InvalidRows.Add(FName{ *(FString::FromInt(WeaponKey) + TEXT(".") + FString::FromInt(Skill.Key)) });
+	}
+
+	int32 OverrideSlotNum = 0;
+	for (const FComboNode& Node : Nodes)
+	{
+		int32& SlotNum = Node.bIsOverrided ? OverrideSlotNum : Entry.CommonSlotNum;
+		SlotNum = FMath::Max(SlotNum, Node.SkillIndex + 1);
+	}
+
+	Entry.SlotNum = Entry.CommonSlotNum + OverrideSlotNum;
+	Entry.SkillData.SetNumZeroed(MaxLevel * Entry.SlotNum);
+	Entry.ResolvedSkills.SetNum(MaxLevel);
+
+	if (!SkillDataTable) return;
+
+	TBitArray<> bIsLoadedSlot{ false, Entry.SlotNum };
+	for (const FComboNode& Node : Nodes)
+	{
+		if (!Node.SkillClass || Node.SkillIndex < 0)
+			continue;
+
+		const int32 Slot = Node.bIsOverrided ? Entry.CommonSlotNum + Node.SkillIndex : Node.SkillIndex;
+		if (bIsLoadedSlot[Slot]) continue;
+		bIsLoadedSlot[Slot] = true;
+
+		for (uint8 Level = 0u; Level < MaxLevel; ++Level)
+		{
+			const FName SkillKey{ *(FString::FromInt(WeaponKey) + FString::FromInt(Level)
+				+ FString::FromInt(Node.bIsOverrided ? 1 : 0) + FString::FromInt(Node.SkillIndex)) };
+
+			if (const auto* Row = SkillDataTable->FindRow<FSkillData>(SkillKey, TEXT(""), false))
+				Entry.SkillData[Level * Entry.SlotNum + Slot] = Row->Data;
+			else
+				Report.MissingRows.Add(SkillKey);
+		}
+	}
+}
+
+bool UCombatDataSubsystem::ParseKey(FName RowName, uint8& OutKey)
+{
+	const FString Name = RowName.ToString();
+	const int32 Key = Name.IsNumeric() ? FCString::Atoi(*Name) : -1;
+
+	if (Key < 0 || Key >= InvalidKey)
+	{
+		Report.InvalidRows.Add(RowName);
+		return false;
+	}
+
+	OutKey = static_cast<uint8>(Key);
+	return true;
+}
+
+void UCombatDataSubsystem::UpdatePrefetch()
+{
+	Loadouts.RemoveAllSwap([](const FLoadout& Loadout) { return !Loadout.Owner.IsValid(); });
+
+	const APlayerController* Controller = GetGameInstance()->GetFirstLocalPlayerController();
+	if (!Controller || Loadouts.Num() == 0)
+		return;
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	Loadouts.Sort([&ViewLocation](const FLoadout& A, const FLoadout& B)
+	{
+		return FVector::DistSquared(A.Owner->GetActorLocation(), ViewLocation)
+			< FVector::DistSquared(B.Owner->GetActorLocation(), ViewLocation);
+	});
+
+	// Equipped weapons are visible at any distance, so they never count against the budget.
+	TBitArray<> bIsWanted{ false, Weapons.Num() };
+	for (const FLoadout& Loadout : Loadouts)
+		if (bIsWanted.IsValidIndex(Loadout.EquippedKey))
+			bIsWanted[Loadout.EquippedKey] = true;
+
+	int32 WantedNum = 0;
+	for (const FLoadout& Loadout : Loadouts)
+	{
+		for (const uint8 Key : Loadout.Keies)
+		{
+			if (WantedNum >= PrefetchBudget) break;
+			if (!bIsWanted.IsValidIndex(Key) || bIsWanted[Key]) continue;
+
+			bIsWanted[Key] = true;
+			++WantedNum;
+		}
+	}
+
+	const int32 WeaponNum = Weapons.Num();
+	for (int32 Key = 0; Key < WeaponNum; ++Key)
+	{
+		if (bIsWanted[Key])
+			GetWeapon(static_cast<uint8>(Key));
+		else if (WeaponArchetypes.IsValidIndex(Key) && WeaponArchetypes[Key])
+			WeaponArchetypes[Key]->Unload();
+	}
+}
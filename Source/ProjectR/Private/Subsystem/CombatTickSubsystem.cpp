@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/CombatTickSubsystem.h"
+#include "Engine/World.h"
+#include "Component/WeaponMeshComponent.h"
+#include "Misc/SkillContext.h"
+#include "Skill/Skill.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queries Submitted"), STAT_CombatQueriesSubmitted, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queries Consumed"), STAT_CombatQueriesConsumed, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Submit Queries"), STAT_CombatSubmitQueries, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Consume Queries"), STAT_CombatConsumeQueries, STATGROUP_Combat);
+
+UCombatTickSubsystem* UCombatTickSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatTickSubsystem>() : nullptr;
+}
+
+void UCombatTickSubsystem::RegisterSkill(USkill* Skill)
+{
+	if (Skill->IsTickable())
+		Skills.AddUnique(Skill);
+}
+
+void UCombatTickSubsystem::UnregisterSkill(USkill* Skill)
+{
+	const int32 Idx = Skills.Find(Skill);
+	if (Idx == INDEX_NONE) return;
+
+	// Slots are only cleared while ticking and compacted once the loop is over.
+	if (bIsTicking)
+		Skills[Idx] = nullptr;
+	else
+		Skills.RemoveAtSwap(Idx);
+}
+
+void UCombatTickSubsystem::RegisterSwap(UWeaponMeshComponent* Mesh)
+{
+	Swaps.AddUnique(Mesh);
+}
+
+void UCombatTickSubsystem::RegisterContext(USkillContext* Context)
+{
+	Contexts.AddUnique(Context);
+}
+
+void UCombatTickSubsystem::UnregisterContext(USkillContext* Context)
+{
+	const int32 Idx = Contexts.Find(Context);
+	if (Idx == INDEX_NONE) return;
+
+	if (bIsTicking)
+		Contexts[Idx] = nullptr;
+	else
+		Contexts.RemoveAtSwap(Idx);
+}
+
+void UCombatTickSubsystem::AsyncLineTrace(const FVector& Start, const FVector& End,
+	const FCollisionObjectQueryParams& ObjectParams, const FOnCombatQuery& Callback)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatSubmitQueries);
+	INC_DWORD_STAT(STAT_CombatQueriesSubmitted);
+
+	const FTraceHandle Handle = GetWorld()->AsyncLineTraceByObjectType(
+		EAsyncTraceType::Single, Start, End, ObjectParams);
+
+	PendingQueries.Add(FPendingQuery{ Handle, Callback });
+}
+
+void UCombatTickSubsystem::ConsumeQueries()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatConsumeQueries);
+
+	UWorld* World = GetWorld();
+	TArray<FPendingQuery> Queries = MoveTemp(PendingQueries);
+	for (FPendingQuery& Query : Queries)
+	{
+		// Data of an unfinished query stays queued for the next frame.
+		FTraceDatum Datum;
+		if (!World->QueryTraceData(Query.Handle, Datum))
+		{
+			if (World->IsTraceHandleValid(Query.Handle, false))
+				PendingQueries.Add(MoveTemp(Query));
+
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_CombatQueriesConsumed);
+		Query.Callback.ExecuteIfBound(Datum.OutHits);
+	}
+}
+
+void UCombatTickSubsystem::Tick(float DeltaTime)
+{
+	ConsumeQueries();
+
+	bIsTicking = true;
+
+	const int32 SkillNum = Skills.Num();
+	for (int32 Idx = 0; Idx < SkillNum; ++Idx)
+		if (USkill* Skill = Skills[Idx])
+			Skill->Tick(DeltaTime);
+
+	// Hits are swept after skills have moved their users this frame.
+	const int32 ContextNum = Contexts.Num();
+	for (int32 Idx = 0; Idx < ContextNum; ++Idx)
+		if (USkillContext* Context = Contexts[Idx])
+			Context->TickHit();
+
+	bIsTicking = false;
+	Skills.Remove(nullptr);
+	Contexts.Remove(nullptr);
+
+	for (int32 Idx = Swaps.Num() - 1; Idx >= 0; --Idx)
+		if (!Swaps[Idx] || !Swaps[Idx]->TickSwap(DeltaTime))
+			Swaps.RemoveAtSwap(Idx);
+}
+
+bool UCombatTickSubsystem::IsTickable() const
+{
+	return Skills.Num() > 0 || Swaps.Num() > 0 ||
+		Contexts.Num() > 0 || PendingQueries.Num() > 0;
+}
+
+ETickableTickType UCombatTickSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UCombatTickSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UCombatTickSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatTickSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/DamageSubsystem.h"
+#include "Engine/World.h"
+#include "Perception/AIPerceptionSystem.h"
+#include "Perception/AISense_Damage.h"
+#include "Framework/PRCharacter.h"
+#include "Framework/PRPlayerController.h"
+#include "Subsystem/CombatTickSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damages Queued"), STAT_DamagesQueued, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hits Sent"), STAT_HitsSent, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Resolve Damages"), STAT_ResolveDamages, STATGROUP_Combat);
+
+UDamageSubsystem* UDamageSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UDamageSubsystem>() : nullptr;
+}
+
+void UDamageSubsystem::QueueDamage(AActor* Target, float Damage, AController* Instigator, AActor* Causer)
+{
+	if (!Target || Damage <= 0.0f) return;
+
+	PendingDamages.Add(FPendingDamage{ Target, Instigator, Causer, Damage });
+	INC_DWORD_STAT(STAT_DamagesQueued);
+}
+
+void UDamageSubsystem::AddHit(APRCharacter* Target, float Damage, APRCharacter* Causer)
+{
+	const uint16 Amount = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Damage), 1, MAX_uint16));
+
+	// Several hits of one causer on one target within a frame are shown as one.
+	for (FHitNotify& Hit : Hits)
+	{
+		if (Hit.Target == Target && Hit.Causer == Causer)
+		{
+			Hit.Damage = static_cast<uint16>(FMath::Min(Hit.Damage + Amount, static_cast<int32>(MAX_uint16)));
+			return;
+		}
+	}
+
+	Hits.Add(FHitNotify{ Target, Causer, Amount });
+}
+
+void UDamageSubsystem::ApplyDamages()
+{
+	// Damage queued while resolving, e.g. by death events, waits for the next frame.
+	TArray<FPendingDamage> Damages = MoveTemp(PendingDamages);
+
+	for (const FPendingDamage& Pending : Damages)
+	{
+		AActor* Target = Pending.Target.Get();
+		if (!IsValid(Target)) continue;
+
+		Target->TakeDamage(Pending.Damage, FDamageEvent{}, Pending.Instigator.Get(), Pending.Causer.Get());
+	}
+}
+
+void UDamageSubsystem::SendHits()
+{
+	// The server hears every hit once; remote players only the ones relevant to them.
+	for (const FHitNotify& Hit : Hits)
+		if (IsValid(Hit.Target))
+			Hit.Target->OnDamaged.Broadcast(Hit.Damage, Hit.Causer);
+
+	TArray<FHitNotify> Batch;
+	for (auto Iter = GetWorld()->GetPlayerControllerIterator(); Iter; ++Iter)
+	{
+		auto* Controller = Cast<APRPlayerController>(Iter->Get());
+		if (!Controller || Controller->IsLocalController()) continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		const AActor* ViewTarget = Controller->GetViewTarget();
+
+		Batch.Reset();
+		for (const FHitNotify& Hit : Hits)
+			if (IsValid(Hit.Target) && Hit.Target->IsNetRelevantFor(Controller, ViewTarget, ViewLocation))
+				Batch.Add(Hit);
+
+		if (Batch.Num() == 0) continue;
+
+		Controller->ClientReceiveHits(Batch);
+		INC_DWORD_STAT_BY(STAT_HitsSent, Batch.Num());
+	}
+}
+
+void UDamageSubsystem::ReportHits()
+{
+	auto* Perception = UAIPerceptionSystem::GetCurrent(GetWorld());
+	if (!Perception) return;
+
+	for (const FHitNotify& Hit : Hits)
+	{
+		if (!IsValid(Hit.Target) || !IsValid(Hit.Causer)) continue;
+
+		Perception->OnEvent(FAIDamageEvent{ Hit.Target, Hit.Causer, static_cast<float>(Hit.Damage),
+			Hit.Causer->GetActorLocation(), Hit.Target->GetActorLocation() });
+	}
+}
+
+void UDamageSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ResolveDamages);
+
+	ApplyDamages();
+	if (Hits.Num() == 0) return;
+
+	SendHits();
+	ReportHits();
+	Hits.Reset();
+}
+
+bool UDamageSubsystem::IsTickable() const
+{
+	return PendingDamages.Num() > 0 || Hits.Num() > 0;
+}
+
+ETickableTickType UDamageSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UDamageSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageSubsystem, STATGROUP_Tickables);
+}
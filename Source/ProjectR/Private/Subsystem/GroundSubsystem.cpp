@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/GroundSubsystem.h"
+#include "Engine/World.h"
+#include "Subsystem/CombatTickSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ground Cache Hits"), STAT_GroundCacheHits, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ground Traces"), STAT_GroundTraces, STATGROUP_Combat);
+
+UGroundSubsystem* UGroundSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UGroundSubsystem>() : nullptr;
+}
+
+bool UGroundSubsystem::GetGroundHeight(const AActor* Target, float& OutHeight)
+{
+	if (!Target) return false;
+
+	FGroundEntry* Entry = Entries.Find(Target);
+	if (!Entry)
+	{
+		// Destroyed actors are dropped whenever a new one starts being tracked.
+		for (auto Iter = Entries.CreateIterator(); Iter; ++Iter)
+			if (!Iter->Key.IsValid())
+				Iter.RemoveCurrent();
+
+		Entry = &Entries.Add(Target, FGroundEntry{ FVector2D::ZeroVector, 0.0f, false, false });
+	}
+
+	const FVector Location = Target->GetActorLocation();
+	if (!Entry->bIsPending && (!Entry->bIsValid
+		|| FVector2D::DistSquared(Entry->SampledAt, FVector2D{ Location }) > FMath::Square(MoveThreshold)))
+	{
+		TraceTarget(Target, *Entry);
+	}
+
+	if (Entry->bIsValid)
+	{
+		INC_DWORD_STAT(STAT_GroundCacheHits);
+		OutHeight = Entry->Height;
+		return true;
+	}
+
+	return GetCellHeight(Location, OutHeight);
+}
+
+bool UGroundSubsystem::GetCellHeight(const FVector& Location, float& OutHeight)
+{
+	const FIntPoint Cell = ToCell(Location);
+	if (const auto* Floors = Cells.Find(Cell))
+	{
+		// The ground is the highest floor below, allowing for a location sampled at the feet.
+		for (int32 Idx = Floors->Num() - 1; Idx >= 0; --Idx)
+		{
+			if ((*Floors)[Idx] <= Location.Z + FloorGap * 0.5f)
+			{
+				INC_DWORD_STAT(STAT_GroundCacheHits);
+				OutHeight = (*Floors)[Idx];
+				return true;
+			}
+		}
+	}
+
+	auto* TickSubsystem = UCombatTickSubsystem::Get(this);
+	if (!TickSubsystem || PendingCells.Contains(Cell))
+		return false;
+
+	FCollisionObjectQueryParams Params;
+	Params.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldStatic);
+
+	const FVector Start{ (Cell.X + 0.5f) * CellSize, (Cell.Y + 0.5f) * CellSize, Location.Z + CellSize };
+	TickSubsystem->AsyncLineTrace(Start, Start - FVector{ 0.0f, 0.0f, TraceDepth }, Params,
+		FOnCombatQuery::CreateUObject(this, &UGroundSubsystem::OnCellTraced, Cell));
+
+	PendingCells.Add(Cell);
+	INC_DWORD_STAT(STAT_GroundTraces);
+	return false;
+}
+
+void UGroundSubsystem::BakeHeightfield(const FVector& Center, const FVector& Extent)
+{
+	const FIntPoint Min = ToCell(Center - Extent);
+	const FIntPoint Max = ToCell(Center + Extent);
+
+	FCollisionObjectQueryParams Params;
+	Params.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldStatic);
+
+	for (int32 X = Min.X; X <= Max.X; ++X)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			const FVector2D CellCenter{ (X + 0.5f) * CellSize, (Y + 0.5f) * CellSize };
+			const FVector Start{ CellCenter, Center.Z + Extent.Z };
+			const FVector End{ CellCenter, Center.Z - Extent.Z };
+
+			// Object queries report every surface along the ray, so one trace finds all floors of the cell.
+			TArray<FHitResult> Hits;
+			GetWorld()->LineTraceMultiByObjectType(Hits, Start, End, Params);
+
+			for (const FHitResult& Hit : Hits)
+				if (!Hit.bStartPenetrating)
+					AddFloor(FIntPoint{ X, Y }, Hit.Location.Z);
+		}
+	}
+}
+
+void UGroundSubsystem::TraceTarget(const AActor* Target, FGroundEntry& Entry)
+{
+	auto* TickSubsystem = UCombatTickSubsystem::Get(this);
+	if (!TickSubsystem) return;
+
+	FCollisionObjectQueryParams Params;
+	Params.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldStatic);
+
+	const FVector Start = Target->GetActorLocation();
+	TickSubsystem->AsyncLineTrace(Start, Start - FVector{ 0.0f, 0.0f, TraceDepth }, Params,
+		FOnCombatQuery::CreateUObject(this, &UGroundSubsystem::OnTargetTraced, TWeakObjectPtr<const AActor>{ Target }));
+
+	Entry.bIsPending = true;
+	INC_DWORD_STAT(STAT_GroundTraces);
+}
+
+void UGroundSubsystem::OnTargetTraced(const TArray<FHitResult>& Hits, TWeakObjectPtr<const AActor> Target)
+{
+	FGroundEntry* Entry = Entries.Find(Target);
+	if (!Entry) return;
+
+	if (!Target.IsValid())
+	{
+		Entries.Remove(Target);
+		return;
+	}
+
+	Entry->bIsPending = false;
+	Entry->bIsValid = Hits.Num() > 0 && Hits[0].bBlockingHit;
+	if (!Entry->bIsValid) return;
+
+	Entry->SampledAt = FVector2D{ Hits[0].TraceStart };
+	Entry->Height = Hits[0].Location.Z;
+
+	// Every target trace also fills the heightfield for free.
+	AddFloor(ToCell(Hits[0].Location), Entry->Height);
+}
+
+void UGroundSubsystem::OnCellTraced(const TArray<FHitResult>& Hits, FIntPoint Cell)
+{
+	PendingCells.Remove(Cell);
+
+	if (Hits.Num() > 0 && Hits[0].bBlockingHit)
+		AddFloor(Cell, Hits[0].Location.Z);
+}
+
+void UGroundSubsystem::AddFloor(const FIntPoint& Cell, float Height)
+{
+	auto& Floors = Cells.FindOrAdd(Cell);
+
+	int32 Idx = 0;
+	while (Idx < Floors.Num() && Floors[Idx] < Height - FloorGap)
+		++Idx;
+
+	if (Idx < Floors.Num() && Floors[Idx] <= Height + FloorGap)
+		Floors[Idx] = Height;
+	else if (Floors.Num() < MaxFloors)
+		Floors.Insert(Height, Idx);
+}
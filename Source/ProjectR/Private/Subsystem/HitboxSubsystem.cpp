@@ -0,0 +1,273 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/HitboxSubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Framework/PRCharacter.h"
+#include "Subsystem/CombatTickSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitbox Candidates"), STAT_HitboxCandidates, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Hitbox Build"), STAT_HitboxBuild, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Hitbox Query"), STAT_HitboxQuery, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Hitbox Rewind"), STAT_HitboxRewind, STATGROUP_Combat);
+
+UHitboxSubsystem::UHitboxSubsystem()
+	: Super()
+{
+	HistoryDepth = 0.5f;
+	HistoryRate = 30.0f;
+	HistoryBudget = 1024;
+	RewindMargin = 300.0f;
+
+	LastRecordTime = 0.0f;
+	MaxHitRadius = 0.0f;
+	BuiltFrame = 0u;
+}
+
+UHitboxSubsystem* UHitboxSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UHitboxSubsystem>() : nullptr;
+}
+
+void UHitboxSubsystem::Register(APRCharacter* Character)
+{
+	if (Characters.Contains(Character))
+		return;
+
+	const int32 Capacity = FMath::Min(FMath::CeilToInt(HistoryDepth * HistoryRate) + 1,
+		HistoryBudget / FHitboxHistory::SampleSize);
+
+	Characters.Add(Character);
+	Histories.AddDefaulted_GetRef().Reset(Capacity);
+	BuiltFrame = 0u;
+}
+
+void UHitboxSubsystem::Unregister(APRCharacter* Character)
+{
+	const int32 Idx = Characters.Find(Character);
+	if (Idx == INDEX_NONE) return;
+
+	Characters.RemoveAtSwap(Idx);
+	Histories.RemoveAtSwap(Idx);
+	BuiltFrame = 0u;
+}
+
+void UHitboxSubsystem::OverlapCapsule(const FVector& Start, const FVector& End, float Radius,
+	FGenericTeamId TeamId, const AActor* IgnoredActor, TArray<AActor*>& OutActors, float RewindTime)
+{
+	BuildIfNeeded();
+
+	SCOPE_CYCLE_COUNTER(STAT_HitboxQuery);
+
+	const bool bIsRewound = RewindTime > 0.0f;
+	const float Time = GetWorld()->GetTimeSeconds() - RewindTime;
+
+	FBox2D Box{ FVector2D{ Start }, FVector2D{ Start } };
+	Box += FVector2D{ End };
+	Box = Box.ExpandBy(Radius + MaxHitRadius + (bIsRewound ? RewindMargin : 0.0f));
+
+	const FVector Dir = End - Start;
+	const bool bHasTeam = TeamId != FGenericTeamId::NoTeam;
+
+	Grid.Query(Box, [&](int32 Begin, int32 RangeEnd)
+	{
+		for (int32 Slot = Begin; Slot < RangeEnd; Slot += 4)
+		{
+			const int32 LaneNum = FMath::Min(RangeEnd - Slot, 4);
+
+			// Team filtering happens before the narrowphase so allies never cost a capsule test.
+			int32 LaneMask = 0;
+			for (int32 Lane = 0; Lane < LaneNum; ++Lane)
+				if (!bHasTeam || Teams[Slot + Lane] != TeamId.GetId())
+					LaneMask |= 1 << Lane;
+
+			if (LaneMask == 0) continue;
+			INC_DWORD_STAT_BY(STAT_HitboxCandidates, LaneNum);
+
+			if (!bIsRewound)
+			{
+				LaneMask &= OverlapLanes(&X[Slot], &Y[Slot], &Bottom[Slot], &Top[Slot], &Radii[Slot], Start, Dir, Radius);
+			}
+			else
+			{
+				SCOPE_CYCLE_COUNTER(STAT_HitboxRewind);
+
+				float RewoundX[4], RewoundY[4], RewoundBottom[4], RewoundTop[4];
+				for (int32 Lane = 0; Lane < 4; ++Lane)
+				{
+					const int32 Idx = Slot + Lane;
+					const float HalfSegment = (Top[Idx] - Bottom[Idx]) * 0.5f;
+
+					FVector Center{ X[Idx], Y[Idx], Bottom[Idx] + HalfSegment };
+					if (Lane < LaneNum)
+						Histories[Sources[Idx]].Sample(Time, Center);
+
+					RewoundX[Lane] = Center.X;
+					RewoundY[Lane] = Center.Y;
+					RewoundBottom[Lane] = Center.Z - HalfSegment;
+					RewoundTop[Lane] = Center.Z + HalfSegment;
+				}
+
+				LaneMask &= OverlapLanes(RewoundX, RewoundY, RewoundBottom, RewoundTop, &Radii[Slot], Start, Dir, Radius);
+			}
+
+			for (int32 Lane = 0; Lane < LaneNum; ++Lane)
+				if ((LaneMask & (1 << Lane)) && Owners[Slot + Lane] != IgnoredActor)
+					OutActors.AddUnique(Owners[Slot + Lane]);
+		}
+	});
+}
+
+float UHitboxSubsystem::GetRewindTime(const APawn* Attacker) const
+{
+	const auto* Controller = Attacker ? Attacker->GetController<APlayerController>() : nullptr;
+	if (!Controller || Controller->IsLocalController() || !Controller->PlayerState)
+		return 0.0f;
+
+	return FMath::Min(Controller->PlayerState->ExactPing * 0.001f, HistoryDepth);
+}
+
+void UHitboxSubsystem::Tick(float DeltaTime)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now - LastRecordTime < 1.0f / HistoryRate)
+		return;
+
+	LastRecordTime = Now;
+
+	const int32 Num = Characters.Num();
+	for (int32 Idx = 0; Idx < Num; ++Idx)
+		if (IsValid(Characters[Idx]))
+			Histories[Idx].Record(Now, Characters[Idx]->GetCapsuleComponent()->GetComponentLocation());
+}
+
+bool UHitboxSubsystem::IsTickable() const
+{
+	return Characters.Num() > 0;
+}
+
+ETickableTickType UHitboxSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UHitboxSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UHitboxSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitboxSubsystem, STATGROUP_Tickables);
+}
+
+void UHitboxSubsystem::BuildIfNeeded()
+{
+	if (BuiltFrame == GFrameCounter)
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_HitboxBuild);
+	BuiltFrame = GFrameCounter;
+
+	TArray<int32> Alive;
+	TArray<FVector2D> Points;
+	const int32 CharacterNum = Characters.Num();
+	for (int32 Idx = 0; Idx < CharacterNum; ++Idx)
+	{
+		const APRCharacter* Character = Characters[Idx];
+		if (!IsValid(Character) || Character->IsDeath())
+			continue;
+
+		Alive.Add(Idx);
+		Points.Add(FVector2D{ Character->GetActorLocation() });
+	}
+
+	Grid.Build(Points);
+
+	const int32 Num = Alive.Num();
+	const int32 PaddedNum = Num + 3;
+	X.SetNumZeroed(PaddedNum, false);
+	Y.SetNumZeroed(PaddedNum, false);
+	Bottom.SetNumZeroed(PaddedNum, false);
+	Top.SetNumZeroed(PaddedNum, false);
+	Radii.SetNumZeroed(PaddedNum, false);
+	Teams.SetNumZeroed(Num, false);
+	Sources.SetNumZeroed(Num, false);
+	Owners.SetNumZeroed(Num, false);
+
+	MaxHitRadius = 0.0f;
+	const auto& Order = Grid.GetOrder();
+	for (int32 Slot = 0; Slot < Num; ++Slot)
+	{
+		const int32 Source = Alive[Order[Slot]];
+		APRCharacter* Character = Characters[Source];
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		const FVector Center = Capsule->GetComponentLocation();
+		const float CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+		const float HalfSegment = Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+		X[Slot] = Center.X;
+		Y[Slot] = Center.Y;
+		Bottom[Slot] = Center.Z - HalfSegment;
+		Top[Slot] = Center.Z + HalfSegment;
+		Radii[Slot] = CapsuleRadius;
+		MaxHitRadius = FMath::Max(MaxHitRadius, CapsuleRadius);
+		Teams[Slot] = Character->GetGenericTeamId().GetId();
+		Sources[Slot] = Source;
+		Owners[Slot] = Character;
+	}
+}
+
+int32 UHitboxSubsystem::OverlapLanes(const float* InX, const float* InY, const float* InBottom,
+	const float* InTop, const float* InRadii, const FVector& Start, const FVector& Dir, float Radius)
+{
+	// Closest points between the query segment and four upright segments, after Ericson's segment test.
+	const VectorRegister Zero = VectorZero();
+	const VectorRegister One = VectorOne();
+	const VectorRegister Epsilon = VectorSetFloat1(KINDA_SMALL_NUMBER);
+
+	const VectorRegister CX = VectorLoad(InX);
+	const VectorRegister CY = VectorLoad(InY);
+	const VectorRegister CZ = VectorLoad(InBottom);
+	const VectorRegister H = VectorSubtract(VectorLoad(InTop), CZ);
+	const VectorRegister R = VectorAdd(VectorLoad(InRadii), VectorSetFloat1(Radius));
+
+	const VectorRegister DX = VectorSetFloat1(Dir.X);
+	const VectorRegister DY = VectorSetFloat1(Dir.Y);
+	const VectorRegister DZ = VectorSetFloat1(Dir.Z);
+
+	const VectorRegister RX = VectorSubtract(VectorSetFloat1(Start.X), CX);
+	const VectorRegister RY = VectorSubtract(VectorSetFloat1(Start.Y), CY);
+	const VectorRegister RZ = VectorSubtract(VectorSetFloat1(Start.Z), CZ);
+
+	const VectorRegister A = VectorMax(VectorSetFloat1(Dir.SizeSquared()), Epsilon);
+	const VectorRegister E = VectorMax(VectorMultiply(H, H), Epsilon);
+	const VectorRegister B = VectorMultiply(DZ, H);
+	const VectorRegister C = VectorMultiplyAdd(DX, RX, VectorMultiplyAdd(DY, RY, VectorMultiply(DZ, RZ)));
+	const VectorRegister F = VectorMultiply(H, RZ);
+
+	const VectorRegister Denom = VectorSubtract(VectorMultiply(A, E), VectorMultiply(B, B));
+	const VectorRegister SafeDenom = VectorMax(Denom, Epsilon);
+	VectorRegister S = VectorDivide(VectorSubtract(VectorMultiply(B, F), VectorMultiply(C, E)), SafeDenom);
+	S = VectorSelect(VectorCompareGT(Denom, Epsilon), VectorMin(VectorMax(S, Zero), One), Zero);
+
+	VectorRegister T = VectorDivide(VectorMultiplyAdd(B, S, F), E);
+
+	const VectorRegister BelowMask = VectorCompareGT(Zero, T);
+	const VectorRegister AboveMask = VectorCompareGT(T, One);
+	const VectorRegister SBelow = VectorMin(VectorMax(VectorDivide(VectorNegate(C), A), Zero), One);
+	const VectorRegister SAbove = VectorMin(VectorMax(VectorDivide(VectorSubtract(B, C), A), Zero), One);
+
+	S = VectorSelect(BelowMask, SBelow, VectorSelect(AboveMask, SAbove, S));
+	T = VectorMin(VectorMax(T, Zero), One);
+
+	const VectorRegister PX = VectorMultiplyAdd(DX, S, RX);
+	const VectorRegister PY = VectorMultiplyAdd(DY, S, RY);
+	const VectorRegister PZ = VectorSubtract(VectorMultiplyAdd(DZ, S, RZ), VectorMultiply(H, T));
+
+	const VectorRegister DistSquared = VectorMultiplyAdd(PX, PX, VectorMultiplyAdd(PY, PY, VectorMultiply(PZ, PZ)));
+	return VectorMaskBits(VectorCompareGE(VectorMultiply(R, R), DistSquared));
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/LockOnSubsystem.h"
+#include "Engine/World.h"
+#include "Framework/PRCharacter.h"
+#include "Framework/PRPlayerController.h"
+
+ULockOnSubsystem* ULockOnSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<ULockOnSubsystem>() : nullptr;
+}
+
+void ULockOnSubsystem::Register(APRCharacter* Owner, AActor* Target)
+{
+	FLock* Lock = Locks.FindByPredicate([Owner](const FLock& Other) { return Other.Owner == Owner; });
+	if (!Lock)
+		Lock = &Locks.Add_GetRef(FLock{ Owner, nullptr });
+
+	AActor* OldTarget = Lock->Target.Get();
+	if (OldTarget == Target) return;
+
+	Lock->Target = Target;
+	BindTarget(Target);
+	ReleaseTarget(OldTarget);
+}
+
+void ULockOnSubsystem::Unregister(APRCharacter* Owner)
+{
+	const int32 Idx = Locks.IndexOfByPredicate([Owner](const FLock& Other) { return Other.Owner == Owner; });
+	if (Idx == INDEX_NONE) return;
+
+	AActor* OldTarget = Locks[Idx].Target.Get();
+	Locks.RemoveAtSwap(Idx, 1, false);
+	ReleaseTarget(OldTarget);
+}
+
+void ULockOnSubsystem::NotifyTargetLost(APRCharacter* Owner, AActor* LostTarget)
+{
+	if (!Owner || !Owner->HasAuthority()) return;
+
+	if (auto* Controller = Owner->GetController<APRPlayerController>())
+		Controller->Relock(LostTarget);
+	else
+		Owner->Unlock();
+}
+
+void ULockOnSubsystem::Tick(float DeltaTime)
+{
+	for (const FLock& Lock : Locks)
+	{
+		const APRCharacter* Owner = Lock.Owner.Get();
+		const AActor* Target = Lock.Target.Get();
+		if (!Owner || !Target || !Owner->IsLocallyControlled())
+			continue;
+
+		AController* Controller = Owner->GetController();
+		if (!Controller) continue;
+
+		FVector MyEyeLoc; FRotator MyEyeRot;
+		Owner->GetActorEyesViewPoint(MyEyeLoc, MyEyeRot);
+
+		FVector TargetEyeLoc; FRotator TargetEyeRot;
+		Target->GetActorEyesViewPoint(TargetEyeLoc, TargetEyeRot);
+
+		const FRotator LookRot = (TargetEyeLoc - MyEyeLoc).Rotation();
+		Controller->SetControlRotation(FMath::Lerp(Controller->GetControlRotation(),
+			LookRot, DeltaTime * ControlRotationSpeed));
+	}
+}
+
+bool ULockOnSubsystem::IsTickable() const
+{
+	return Locks.Num() > 0;
+}
+
+ETickableTickType ULockOnSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* ULockOnSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId ULockOnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULockOnSubsystem, STATGROUP_Tickables);
+}
+
+void ULockOnSubsystem::BindTarget(AActor* Target)
+{
+	if (auto* Character = Cast<APRCharacter>(Target))
+		Character->OnDeath.AddUniqueDynamic(this, &ULockOnSubsystem::OnTargetDeath);
+}
+
+void ULockOnSubsystem::ReleaseTarget(AActor* Target)
+{
+	auto* Character = Cast<APRCharacter>(Target);
+	if (!Character) return;
+
+	const bool bIsStillLocked = Locks.ContainsByPredicate([Target](const FLock& Lock) { return Lock.Target == Target; });
+	if (!bIsStillLocked)
+		Character->OnDeath.RemoveDynamic(this, &ULockOnSubsystem::OnTargetDeath);
+}
+
+void ULockOnSubsystem::OnTargetDeath()
+{
+	// Death carries no payload, so every lock on a target that is dead by now is handled here.
+	TArray<FLock> LostLocks;
+	for (const FLock& Lock : Locks)
+	{
+		const auto* Target = Cast<APRCharacter>(Lock.Target.Get());
+		if (Target && Target->IsDeath())
+			LostLocks.Add(Lock);
+	}
+
+	for (const FLock& Lock : LostLocks)
+		NotifyTargetLost(Lock.Owner.Get(), Lock.Target.Get());
+}
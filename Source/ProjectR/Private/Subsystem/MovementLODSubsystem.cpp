@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/MovementLODSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Component/PRMovementComponent.h"
+#include "Framework/PRCharacter.h"
+#include "Subsystem/CombatTickSubsystem.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Movement LOD Full"), STAT_MovementLODFull, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Movement LOD Reduced"), STAT_MovementLODReduced, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Movement LOD Minimal"), STAT_MovementLODMinimal, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Movement LOD Update"), STAT_MovementLODUpdate, STATGROUP_Combat);
+
+UMovementLODSubsystem::UMovementLODSubsystem()
+	: Super()
+{
+	NearDistance = 2500.0f;
+	FarDistance = 6000.0f;
+	Hysteresis = 0.15f;
+	OffscreenScale = 2.0f;
+	UpdateInterval = 0.5f;
+	ElapsedTime = 0.0f;
+}
+
+UMovementLODSubsystem* UMovementLODSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMovementLODSubsystem>() : nullptr;
+}
+
+void UMovementLODSubsystem::Register(APRCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UMovementLODSubsystem::Unregister(APRCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character, false);
+}
+
+void UMovementLODSubsystem::Tick(float DeltaTime)
+{
+	ElapsedTime += DeltaTime;
+	if (ElapsedTime < UpdateInterval)
+		return;
+
+	ElapsedTime = 0.0f;
+	UpdateLODs();
+}
+
+bool UMovementLODSubsystem::IsTickable() const
+{
+	return Characters.Num() > 0;
+}
+
+ETickableTickType UMovementLODSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UMovementLODSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UMovementLODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMovementLODSubsystem, STATGROUP_Tickables);
+}
+
+void UMovementLODSubsystem::UpdateLODs()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MovementLODUpdate);
+
+	Viewers.Reset();
+	for (auto Iter = GetWorld()->GetPlayerControllerIterator(); Iter; ++Iter)
+	{
+		const APlayerController* Controller = Iter->Get();
+		const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+		if (!Pawn) continue;
+
+		const FVector2D Forward = FVector2D{ Controller->GetControlRotation().Vector() }.GetSafeNormal();
+		Viewers.Add(FViewer{ Pawn->GetActorLocation(), Forward });
+	}
+
+	int32 TierNums[3] = { 0, 0, 0 };
+	for (APRCharacter* Character : Characters)
+	{
+		if (!IsValid(Character)) continue;
+
+		auto* Movement = Cast<UPRMovementComponent>(Character->GetCharacterMovement());
+		if (!Movement) continue;
+
+		// Players always move at full fidelity, both their own and the ones they see up close.
+		const EMovementLOD NewLOD = Character->IsPlayerControlled() ? EMovementLOD::Full
+			: SelectLOD(Movement->GetMovementLOD(), GetSignificance(Character->GetActorLocation()));
+
+		Movement->SetMovementLOD(NewLOD);
+		++TierNums[static_cast<int32>(NewLOD)];
+	}
+
+	SET_DWORD_STAT(STAT_MovementLODFull, TierNums[0]);
+	SET_DWORD_STAT(STAT_MovementLODReduced, TierNums[1]);
+	SET_DWORD_STAT(STAT_MovementLODMinimal, TierNums[2]);
+}
+
+float UMovementLODSubsystem::GetSignificance(const FVector& Location) const
+{
+	float Significance = MAX_flt;
+
+	for (const FViewer& Viewer : Viewers)
+	{
+		const FVector Delta = Location - Viewer.Location;
+		float Distance = Delta.Size();
+
+		if (FVector2D::DotProduct(Viewer.Forward, FVector2D{ Delta }) < 0.0f)
+			Distance *= OffscreenScale;
+
+		Significance = FMath::Min(Significance, Distance);
+	}
+
+	return Significance;
+}
+
+EMovementLOD UMovementLODSubsystem::SelectLOD(EMovementLOD Current, float Significance) const
+{
+	// Thresholds sit further out for the tier a character is already in, so it does not flicker at the border.
+	const float NearLimit = NearDistance * (Current == EMovementLOD::Full ? 1.0f + Hysteresis : 1.0f - Hysteresis);
+	const float FarLimit = FarDistance * (Current == EMovementLOD::Minimal ? 1.0f - Hysteresis : 1.0f + Hysteresis);
+
+	if (Significance < NearLimit)
+		return EMovementLOD::Full;
+
+	return Significance < FarLimit ? EMovementLOD::Reduced : EMovementLOD::Minimal;
+}
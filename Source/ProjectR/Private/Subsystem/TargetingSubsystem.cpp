@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystem/TargetingSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "Component/TargetComponent.h"
+#include "Framework/PRCharacter.h"
+#include "Subsystem/CombatTickSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Targeting Viewers"), STAT_TargetingViewers, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Targeting Update"), STAT_TargetingUpdate, STATGROUP_Combat);
+
+UTargetingSubsystem::UTargetingSubsystem()
+	: Super(), Grid(1000.0f)
+{
+}
+
+UTargetingSubsystem* UTargetingSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UTargetingSubsystem>() : nullptr;
+}
+
+void UTargetingSubsystem::RegisterCharacter(APRCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UTargetingSubsystem::UnregisterCharacter(APRCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character, false);
+}
+
+void UTargetingSubsystem::RegisterViewer(UTargetComponent* Viewer)
+{
+	Viewers.AddUnique(Viewer);
+}
+
+void UTargetingSubsystem::UnregisterViewer(UTargetComponent* Viewer)
+{
+	Viewers.RemoveSingleSwap(Viewer, false);
+	Sight.Remove(Viewer);
+}
+
+void UTargetingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TargetingUpdate);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	bool bIsBuilt = false;
+
+	for (int32 Idx = 0; Idx < Viewers.Num(); ++Idx)
+	{
+		UTargetComponent* Viewer = Viewers[Idx];
+		if (!IsValid(Viewer))
+			continue;
+
+		// Turning only reorders the candidates already in sight, which needs no grid.
+		if (!Viewer->IsUpdateDue(Now))
+		{
+			Viewer->UpdateView();
+			continue;
+		}
+
+		// Viewers update on their own intervals, so frames where none is due skip the grid.
+		if (!bIsBuilt)
+		{
+			BuildGrid();
+			bIsBuilt = true;
+		}
+
+		Candidates.Reset();
+		QueryViewer(Viewer, Candidates);
+		FilterVisible(Viewer, Candidates);
+		Viewer->UpdateCandidates(Candidates, Now);
+
+		INC_DWORD_STAT(STAT_TargetingViewers);
+	}
+}
+
+bool UTargetingSubsystem::IsTickable() const
+{
+	return Viewers.Num() > 0;
+}
+
+ETickableTickType UTargetingSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UTargetingSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UTargetingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTargetingSubsystem, STATGROUP_Tickables);
+}
+
+void UTargetingSubsystem::BuildGrid()
+{
+	TArray<APRCharacter*> Alive;
+	TArray<FVector2D> Points;
+
+	for (APRCharacter* Character : Characters)
+	{
+		if (!IsValid(Character) || Character->IsDeath())
+			continue;
+
+		Alive.Add(Character);
+		Points.Add(FVector2D{ Character->GetActorLocation() });
+	}
+
+	Grid.Build(Points);
+
+	const TArray<int32>& Order = Grid.GetOrder();
+	const int32 Num = Order.Num();
+
+	Locations.SetNumUninitialized(Num, false);
+	Teams.SetNumUninitialized(Num, false);
+	Owners.SetNumUninitialized(Num, false);
+
+	for (int32 Slot = 0; Slot < Num; ++Slot)
+	{
+		APRCharacter* Character = Alive[Order[Slot]];
+		Locations[Slot] = Character->GetActorLocation();
+		Teams[Slot] = Character->GetGenericTeamId().GetId();
+		Owners[Slot] = Character;
+	}
+}
+
+void UTargetingSubsystem::QueryViewer(const UTargetComponent* Viewer, TArray<AActor*>& OutCandidates) const
+{
+	FVector Location;
+	FRotator Rotation;
+	Viewer->GetView(Location, Rotation);
+
+	const AActor* Self = Viewer->GetOwner();
+	if (const auto* Controller = Cast<AController>(Self))
+		Self = Controller->GetPawn();
+
+	const FGenericTeamId TeamId = FGenericTeamId::GetTeamIdentifier(Self);
+	const bool bHasTeam = TeamId != FGenericTeamId::NoTeam;
+
+	const float RadiusSq = FMath::Square(Viewer->GetSightRadius());
+	const float MinCos = FMath::Cos(FMath::DegreesToRadians(Viewer->GetSightAngle()));
+	const FVector2D Forward = FVector2D{ Rotation.Vector() }.GetSafeNormal();
+
+	const FVector2D Center{ Location };
+	const FBox2D Box{ Center - Viewer->GetSightRadius(), Center + Viewer->GetSightRadius() };
+
+	Grid.Query(Box, [&](int32 Begin, int32 End)
+	{
+		for (int32 Slot = Begin; Slot < End; ++Slot)
+		{
+			if (Owners[Slot] == Self || (bHasTeam && Teams[Slot] == TeamId.GetId()))
+				continue;
+
+			const FVector Delta = Locations[Slot] - Location;
+			if (Delta.SizeSquared() > RadiusSq)
+				continue;
+
+			const FVector2D Dir = FVector2D{ Delta }.GetSafeNormal();
+			if (!Dir.IsZero() && FVector2D::DotProduct(Forward, Dir) < MinCos)
+				continue;
+
+			OutCandidates.Add(Owners[Slot]);
+		}
+	});
+}
+
+void UTargetingSubsystem::FilterVisible(UTargetComponent* Viewer, TArray<AActor*>& InOutCandidates)
+{
+	auto* TickSubsystem = UCombatTickSubsystem::Get(this);
+	if (!TickSubsystem) return;
+
+	FVector Location;
+	FRotator Rotation;
+	Viewer->GetView(Location, Rotation);
+
+	FCollisionObjectQueryParams Params;
+	Params.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldStatic);
+
+	// Candidates that left the cone are forgotten, so one coming back is traced before it counts as visible.
+	auto& Visibility = Sight.FindOrAdd(Viewer);
+	for (auto Iter = Visibility.CreateIterator(); Iter; ++Iter)
+		if (!InOutCandidates.Contains(Iter->Key.Get()))
+			Iter.RemoveCurrent();
+
+	for (AActor* Candidate : InOutCandidates)
+	{
+		TickSubsystem->AsyncLineTrace(Location, Candidate->GetActorLocation(), Params,
+			FOnCombatQuery::CreateUObject(this, &UTargetingSubsystem::OnSightTraced,
+				TWeakObjectPtr<UTargetComponent>{ Viewer }, TWeakObjectPtr<AActor>{ Candidate }));
+	}
+
+	InOutCandidates.RemoveAll([&Visibility](AActor* Candidate)
+	{
+		const bool* bIsVisible = Visibility.Find(Candidate);
+		return !bIsVisible || !*bIsVisible;
+	});
+}
+
+void UTargetingSubsystem::OnSightTraced(const TArray<FHitResult>& Hits,
+	TWeakObjectPtr<UTargetComponent> Viewer, TWeakObjectPtr<AActor> Candidate)
+{
+	auto* Visibility = Sight.Find(Viewer);
+	if (!Visibility || !Viewer.IsValid() || !Candidate.IsValid())
+		return;
+
+	const bool bIsVisible = !Hits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	const bool* bWasVisible = Visibility->Find(Candidate);
+
+	// A candidate that just came into view is handed over without waiting for the next interval.
+	if (bIsVisible && !(bWasVisible && *bWasVisible))
+		Viewer->RequestUpdate();
+
+	Visibility->Add(Candidate, bIsVisible);
+}
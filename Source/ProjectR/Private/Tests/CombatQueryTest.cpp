@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Subsystem/CombatTickSubsystem.h"
+#include "Tests/CombatTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CombatQueryTest
+{
+	constexpr int32 AttackerNum = 200;
+	constexpr int32 FrameNum = 60;
+	constexpr float Spacing = 300.0f;
+	constexpr float TraceDepth = 1000.0f;
+
+	FVector GetAttackerLocation(int32 Idx)
+	{
+		return FVector{ (Idx % 20) * Spacing, (Idx / 20) * Spacing, 200.0f };
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatQueryQueueTest, "ProjectR.Combat.QueryQueue",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FCombatQueryQueueTest::RunTest(const FString& Parameters)
+{
+	using namespace CombatQueryTest;
+
+	FCombatTestWorld World;
+	auto* TickSubsystem = UCombatTickSubsystem::Get(World.Get());
+	if (!TestNotNull(TEXT("Combat tick subsystem"), TickSubsystem))
+		return false;
+
+	// Uneven ground under every attacker, so each trace has its own hit.
+	for (int32 Idx = 0; Idx < AttackerNum; ++Idx)
+	{
+		const FVector Location = GetAttackerLocation(Idx) - FVector{ 0.0f, 0.0f, 200.0f + (Idx % 7) * 20.0f };
+		World.SpawnBox(Location, FVector{ Spacing * 0.5f, Spacing * 0.5f, 10.0f });
+	}
+
+	FCollisionObjectQueryParams Params;
+	Params.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldStatic);
+
+	double SyncTraceTime = 0.0;
+	double SyncFrameTime = 0.0;
+	int32 SyncHitNum = 0;
+
+	for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+	{
+		const double FrameStart = FPlatformTime::Seconds();
+
+		for (int32 Idx = 0; Idx < AttackerNum; ++Idx)
+		{
+			const FVector Start = GetAttackerLocation(Idx);
+			FHitResult Hit;
+			SyncHitNum += World->LineTraceSingleByObjectType(Hit, Start, Start - FVector{ 0.0f, 0.0f, TraceDepth }, Params);
+		}
+
+		SyncTraceTime += FPlatformTime::Seconds() - FrameStart;
+		World.Tick();
+		SyncFrameTime += FPlatformTime::Seconds() - FrameStart;
+	}
+
+	double SubmitTime = 0.0;
+	double AsyncFrameTime = 0.0;
+	int32 AsyncHitNum = 0;
+	int32 ConsumedNum = 0;
+
+	const FOnCombatQuery Callback = FOnCombatQuery::CreateLambda([&AsyncHitNum, &ConsumedNum](const TArray<FHitResult>& Hits)
+		{
+			++ConsumedNum;
+			AsyncHitNum += Hits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+		});
+
+	for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+	{
+		const double FrameStart = FPlatformTime::Seconds();
+
+		for (int32 Idx = 0; Idx < AttackerNum; ++Idx)
+		{
+			const FVector Start = GetAttackerLocation(Idx);
+			TickSubsystem->AsyncLineTrace(Start, Start - FVector{ 0.0f, 0.0f, TraceDepth }, Params, Callback);
+		}
+
+		SubmitTime += FPlatformTime::Seconds() - FrameStart;
+		World.Tick();
+		AsyncFrameTime += FPlatformTime::Seconds() - FrameStart;
+	}
+
+	// Results of the last frame are consumed on the following one.
+	World.Tick();
+
+	TestEqual(TEXT("Every queued query is consumed"), ConsumedNum, AttackerNum * FrameNum);
+	TestEqual(TEXT("Queued and synchronous traces hit the same ground"), AsyncHitNum, SyncHitNum);
+
+	const double ToMs = 1000.0 / FrameNum;
+	AddInfo(FString::Printf(TEXT("%d traces per frame, sync: %.3f ms tracing, %.3f ms frame"),
+		AttackerNum, SyncTraceTime * ToMs, SyncFrameTime * ToMs));
+	AddInfo(FString::Printf(TEXT("%d traces per frame, queued: %.3f ms submitting, %.3f ms frame"),
+		AttackerNum, SubmitTime * ToMs, AsyncFrameTime * ToMs));
+	AddInfo(FString::Printf(TEXT("Game thread time saved by queuing: %.3f ms per frame"),
+		(SyncTraceTime - SubmitTime) * ToMs));
+
+	return true;
+}
+
+#endif
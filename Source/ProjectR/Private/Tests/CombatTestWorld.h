@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Standalone game world with physics for combat automation tests, torn down with the helper.
+class FCombatTestWorld
+{
+public:
+	FCombatTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+		Context.SetCurrentWorld(World);
+
+		const FURL URL;
+		World->SetGameMode(URL);
+		World->InitializeActorsForPlay(URL);
+		World->BeginPlay();
+	}
+
+	~FCombatTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	FORCEINLINE UWorld* operator->() const noexcept { return World; }
+	FORCEINLINE UWorld* Get() const noexcept { return World; }
+
+	void Tick(float DeltaTime = 1.0f / 60.0f)
+	{
+		World->Tick(ELevelTick::LEVELTICK_All, DeltaTime);
+	}
+
+	// Spawns a static box that blocks queries of ObjectType.
+	AActor* SpawnBox(const FVector& Location, const FVector& Extent,
+		ECollisionChannel ObjectType = ECollisionChannel::ECC_WorldStatic)
+	{
+		AActor* Actor = World->SpawnActor<AActor>(Location, FRotator::ZeroRotator);
+
+		auto* Box = NewObject<UBoxComponent>(Actor);
+		Box->SetBoxExtent(Extent, false);
+		Box->SetCollisionObjectType(ObjectType);
+		Box->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Box->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+		Actor->SetRootComponent(Box);
+		Box->RegisterComponent();
+		Box->SetWorldLocation(Location);
+		return Actor;
+	}
+
+	// Spawns an upright capsule that blocks queries of ObjectType.
+	AActor* SpawnCapsule(const FVector& Location, float Radius, float HalfHeight,
+		ECollisionChannel ObjectType = ECollisionChannel::ECC_Pawn)
+	{
+		AActor* Actor = World->SpawnActor<AActor>(Location, FRotator::ZeroRotator);
+
+		auto* Capsule = NewObject<UCapsuleComponent>(Actor);
+		Capsule->SetCapsuleSize(Radius, HalfHeight, false);
+		Capsule->SetCollisionObjectType(ObjectType);
+		Capsule->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Capsule->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+		Actor->SetRootComponent(Capsule);
+		Capsule->RegisterComponent();
+		Capsule->SetWorldLocation(Location);
+		return Actor;
+	}
+
+private:
+	UWorld* World;
+};
+
+#endif
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/HitboxHistory.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HitboxHistoryTest
+{
+	// Half a second of samples at 30 Hz, the subsystem defaults.
+	constexpr int32 Capacity = 16;
+	constexpr float Rate = 30.0f;
+	constexpr float Tolerance = 0.5f;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitboxHistoryTest, "ProjectR.Combat.Hitbox.History",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHitboxHistoryTest::RunTest(const FString& Parameters)
+{
+	using namespace HitboxHistoryTest;
+
+	constexpr float Speed = 600.0f;
+	constexpr float Rewind = 0.2f;
+
+	FHitboxHistory History;
+	History.Reset(Capacity);
+
+	// A 30 second run covers about 180 m, more than twice the quantization range.
+	int32 MissNum = 0;
+	float Time = 0.0f;
+	for (int32 Step = 0; Step < 30 * static_cast<int32>(Rate); ++Step)
+	{
+		Time = Step / Rate;
+		History.Record(Time, FVector{ Time * Speed, 100.0f, 90.0f });
+
+		if (Time < Rewind)
+			continue;
+
+		FVector Rewound;
+		if (!History.Sample(Time - Rewind, Rewound) ||
+			!Rewound.Equals(FVector{ (Time - Rewind) * Speed, 100.0f, 90.0f }, Tolerance))
+			++MissNum;
+	}
+
+	TestEqual(TEXT("Rewound positions stay exact while walking past the anchor range"), MissNum, 0);
+
+	// A teleport leaves nothing to rewind to but the new location.
+	const FVector Teleported{ 1000000.0f, -1000000.0f, 0.0f };
+	History.Record(Time + 1.0f / Rate, Teleported);
+
+	FVector Rewound;
+	TestTrue(TEXT("History samples after a teleport"), History.Sample(Time - Rewind, Rewound));
+	TestTrue(TEXT("Samples from before a teleport are dropped"), Rewound.Equals(Teleported, Tolerance));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitboxRewindBenchmark, "ProjectR.Combat.Hitbox.Rewind",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHitboxRewindBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HitboxHistoryTest;
+
+	constexpr int32 CharacterNum = 100;
+	constexpr int32 QueryNum = 1000;
+
+	FRandomStream Random{ 14 };
+	TArray<FHitboxHistory> Histories;
+	TArray<FVector> Locations;
+	Histories.SetNum(CharacterNum);
+
+	int32 AllocatedSize = 0;
+	for (FHitboxHistory& History : Histories)
+	{
+		History.Reset(Capacity);
+		AllocatedSize += History.GetAllocatedSize();
+		Locations.Add(FVector{ Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(-5000.0f, 5000.0f), 90.0f });
+	}
+
+	float Time = 0.0f;
+	for (int32 Step = 0; Step < Capacity * 2; ++Step)
+	{
+		Time = Step / Rate;
+		for (int32 Idx = 0; Idx < CharacterNum; ++Idx)
+		{
+			Locations[Idx] += Random.GetUnitVector() * FVector{ 20.0f, 20.0f, 0.0f };
+			Histories[Idx].Record(Time, Locations[Idx]);
+		}
+	}
+
+	// Each query rewinds every character, the worst case of a hit test covering the whole arena.
+	FVector Sum = FVector::ZeroVector;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 Query = 0; Query < QueryNum; ++Query)
+	{
+		const float RewindTime = Time - Random.FRandRange(0.0f, Capacity / Rate);
+		for (const FHitboxHistory& History : Histories)
+		{
+			FVector Rewound;
+			if (History.Sample(RewindTime, Rewound))
+				Sum += Rewound;
+		}
+	}
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+	TestFalse(TEXT("Rewound positions are finite"), Sum.ContainsNaN());
+
+	AddInfo(FString::Printf(TEXT("Rewinding %d characters: %.3f us per query, %d bytes of history"),
+		CharacterNum, Elapsed * 1000000.0 / QueryNum, AllocatedSize));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Subsystem/HitboxSubsystem.h"
+#include "Tests/CombatTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HitboxLanesTest
+{
+	constexpr float ArenaSize = 10000.0f;
+	constexpr float HalfSegment = 50.0f;
+
+	struct FCapsuleLanes
+	{
+		void Add(const FVector& Center, float Radius)
+		{
+			X.Add(Center.X);
+			Y.Add(Center.Y);
+			Bottom.Add(Center.Z - HalfSegment);
+			Top.Add(Center.Z + HalfSegment);
+			Radii.Add(Radius);
+		}
+
+		// Pads by three lanes like the subsystem does for its SIMD loads.
+		void Pad()
+		{
+			for (int32 Idx = 0; Idx < 3; ++Idx)
+				Add(FVector::ZeroVector, 0.0f);
+		}
+
+		int32 Overlap(int32 Slot, const FVector& Start, const FVector& End, float Radius) const
+		{
+			return UHitboxSubsystem::OverlapLanes(&X[Slot], &Y[Slot], &Bottom[Slot], &Top[Slot], &Radii[Slot],
+				Start, End - Start, Radius);
+		}
+
+		TArray<float> X, Y, Bottom, Top, Radii;
+	};
+
+	FVector RandomPoint(FRandomStream& Random)
+	{
+		return FVector{ Random.FRandRange(0.0f, ArenaSize), Random.FRandRange(0.0f, ArenaSize), Random.FRandRange(0.0f, 200.0f) };
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitboxLanesTest, "ProjectR.Combat.Hitbox.Lanes",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHitboxLanesTest::RunTest(const FString& Parameters)
+{
+	using namespace HitboxLanesTest;
+
+	FRandomStream Random{ 13 };
+	int32 CheckedNum = 0;
+	int32 MismatchNum = 0;
+
+	for (int32 Case = 0; Case < 4096; ++Case)
+	{
+		// Capsules around the query so overlaps and misses both come up.
+		const FVector Start{ 500.0f, 500.0f, 100.0f };
+		const FVector End = Start + Random.GetUnitVector() * Random.FRandRange(0.0f, 300.0f);
+		const float Radius = Random.FRandRange(5.0f, 60.0f);
+
+		FCapsuleLanes Lanes;
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+			Lanes.Add(Start + FVector{ Random.FRandRange(-400.0f, 400.0f), Random.FRandRange(-400.0f, 400.0f),
+				Random.FRandRange(-200.0f, 200.0f) }, Random.FRandRange(20.0f, 60.0f));
+
+		const int32 Mask = Lanes.Overlap(0, Start, End, Radius);
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const FVector Bottom{ Lanes.X[Lane], Lanes.Y[Lane], Lanes.Bottom[Lane] };
+			const FVector Top{ Lanes.X[Lane], Lanes.Y[Lane], Lanes.Top[Lane] };
+
+			FVector OnQuery, OnCapsule;
+			FMath::SegmentDistToSegmentSafe(Start, End, Bottom, Top, OnQuery, OnCapsule);
+			const float Distance = FVector::Dist(OnQuery, OnCapsule);
+			const float Reach = Radius + Lanes.Radii[Lane];
+
+			// Grazing contacts are left to float rounding.
+			if (FMath::IsNearlyEqual(Distance, Reach, 0.01f))
+				continue;
+
+			++CheckedNum;
+			MismatchNum += ((Mask & (1 << Lane)) != 0) != (Distance <= Reach);
+		}
+	}
+
+	TestEqual(TEXT("Lane tests agree with the scalar segment distance"), MismatchNum, 0);
+	AddInfo(FString::Printf(TEXT("%d capsule pairs checked"), CheckedNum));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitboxBroadphaseBenchmark, "ProjectR.Combat.Hitbox.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FHitboxBroadphaseBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HitboxLanesTest;
+
+	constexpr int32 CapsuleNum = 1000;
+	constexpr int32 QueryNum = 200;
+	constexpr float CapsuleRadius = 40.0f;
+	constexpr float WeaponRadius = 20.0f;
+
+	FCombatTestWorld World;
+	FRandomStream Random{ 7 };
+
+	FCapsuleLanes Lanes;
+	for (int32 Idx = 0; Idx < CapsuleNum; ++Idx)
+	{
+		const FVector Center = RandomPoint(Random);
+		World.SpawnCapsule(Center, CapsuleRadius, HalfSegment + CapsuleRadius);
+		Lanes.Add(Center, CapsuleRadius);
+	}
+	Lanes.Pad();
+
+	TArray<FVector> Starts, Ends;
+	for (int32 Query = 0; Query < QueryNum; ++Query)
+	{
+		Starts.Add(RandomPoint(Random));
+		Ends.Add(Starts.Last() + Random.GetUnitVector() * 150.0f);
+	}
+
+	// Lets the physics scene pick up the new bodies.
+	World.Tick();
+
+	FCollisionObjectQueryParams Params;
+	Params.AddObjectTypesToQuery(ECollisionChannel::ECC_Pawn);
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(WeaponRadius);
+
+	int32 PhysicsHitNum = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Query = 0; Query < QueryNum; ++Query)
+	{
+		TArray<FHitResult> Hits;
+		World->SweepMultiByObjectType(Hits, Starts[Query], Ends[Query], FQuat::Identity, Params, Shape);
+		PhysicsHitNum += Hits.Num();
+	}
+	const double PhysicsTime = FPlatformTime::Seconds() - StartTime;
+
+	// Every lane of every capsule, without the grid, as an upper bound of the broadphase cost.
+	int32 LaneHitNum = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Query = 0; Query < QueryNum; ++Query)
+		for (int32 Slot = 0; Slot < CapsuleNum; Slot += 4)
+			LaneHitNum += FMath::CountBits(Lanes.Overlap(Slot, Starts[Query], Ends[Query], WeaponRadius)
+				& ((1 << FMath::Min(CapsuleNum - Slot, 4)) - 1));
+	const double LaneTime = FPlatformTime::Seconds() - StartTime;
+
+	TestTrue(TEXT("Lane and physics hits agree"), FMath::Abs(LaneHitNum - PhysicsHitNum) <= FMath::Max(1, PhysicsHitNum / 100));
+
+	AddInfo(FString::Printf(TEXT("%d sweeps against %d capsules, physics: %.3f ms, %d hits"),
+		QueryNum, CapsuleNum, PhysicsTime * 1000.0, PhysicsHitNum));
+	AddInfo(FString::Printf(TEXT("%d sweeps against %d capsules, lanes: %.3f ms, %d hits"),
+		QueryNum, CapsuleNum, LaneTime * 1000.0, LaneHitNum));
+
+	return true;
+}
+
+#endif
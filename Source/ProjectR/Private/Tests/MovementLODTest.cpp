@@ -0,0 +1,219 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Components/BrushComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "NavigationSystem.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Component/PRMovementComponent.h"
+#include "Framework/PRCharacter.h"
+#include "Subsystem/MovementLODSubsystem.h"
+#include "Tests/CombatTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MovementLODTest
+{
+	constexpr int32 MobNum = 1000;
+	constexpr int32 Columns = 40;
+	constexpr float Spacing = 300.0f;
+	constexpr int32 FrameNum = 120;
+
+	APRCharacter* SpawnCharacter(FCombatTestWorld& World, const FVector& Location)
+	{
+		FActorSpawnParameters Params;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		return World->SpawnActor<APRCharacter>(Location, FRotator::ZeroRotator, Params);
+	}
+
+	UPRMovementComponent* GetMovement(const APRCharacter* Character)
+	{
+		return Cast<UPRMovementComponent>(Character->GetCharacterMovement());
+	}
+
+	// Builds a navmesh over Bounds so the reduced tiers really nav walk, and waits until its far corner is navigable.
+	bool BuildNavMesh(FCombatTestWorld& World, const FBox& Bounds, AActor& Floor, AActor& Invoker)
+	{
+		auto* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World.Get());
+		if (!NavSys)
+		{
+			FNavigationSystem::AddNavigationSystemToWorld(*World.Get(), FNavigationSystemRunMode::GameMode);
+			NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World.Get());
+		}
+
+		if (!NavSys)
+			return false;
+
+		UNavigationSystemV1::UpdateComponentInNavOctree(*Floor.GetRootComponent());
+
+		// A runtime volume has no brush model, so a box body gives it its bounds.
+		auto* Volume = World->SpawnActor<ANavMeshBoundsVolume>(Bounds.GetCenter(), FRotator::ZeroRotator);
+		if (!Volume)
+			return false;
+
+		UBrushComponent* Brush = Volume->GetBrushComponent();
+		const FVector Size = Bounds.GetSize();
+		Brush->BrushBodySetup = NewObject<UBodySetup>(Brush);
+		Brush->BrushBodySetup->AggGeom.BoxElems.Add(FKBoxElem{ Size.X, Size.Y, Size.Z });
+		Brush->UpdateBounds();
+		NavSys->OnNavigationBoundsUpdated(Volume);
+
+		// The project only generates tiles around invokers, so the player covers the whole floor.
+		const float Radius = FVector2D{ Size }.Size();
+		NavSys->RegisterInvoker(Invoker, Radius, Radius);
+		NavSys->Build();
+
+		const FVector Corner{ Bounds.Max.X - Spacing, Bounds.Max.Y - Spacing, 0.0f };
+		FNavLocation Projected;
+		for (int32 Frame = 0; Frame < 600; ++Frame)
+		{
+			if (!NavSys->IsNavigationBuildInProgress() && NavSys->ProjectPointToNavigation(Corner, Projected, FVector{ 50.0f, 50.0f, 250.0f }))
+				return true;
+
+			World.Tick(0.1f);
+		}
+
+		return false;
+	}
+
+	// Walks every mob along its own heading, so each frame moves all of them.
+	double RunFrames(FCombatTestWorld& World, const TArray<APRCharacter*>& Mobs)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+		{
+			for (int32 Idx = 0; Idx < Mobs.Num(); ++Idx)
+				Mobs[Idx]->AddMovementInput(FRotator{ 0.0f, Idx * 37.0f + Frame, 0.0f }.Vector());
+
+			World.Tick();
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / FrameNum;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMovementLODRestoreTest, "ProjectR.Movement.LOD.Restore",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FMovementLODRestoreTest::RunTest(const FString& Parameters)
+{
+	using namespace MovementLODTest;
+
+	FCombatTestWorld World;
+	APRCharacter* Character = SpawnCharacter(World, FVector{ 0.0f, 0.0f, 200.0f });
+	UPRMovementComponent* Movement = Character ? GetMovement(Character) : nullptr;
+	if (!TestNotNull(TEXT("Movement component"), Movement))
+		return false;
+
+	// A capsule that only overlaps pawns and a land mode other than walking, so neither matches a hardcoded default.
+	UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+	Capsule->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECR_Overlap);
+	Movement->DefaultLandMovementMode = MOVE_Flying;
+	Movement->SetMovementMode(MOVE_Walking);
+
+	Movement->SetMovementLOD(EMovementLOD::Reduced);
+	TestEqual(TEXT("Reduced tier walks on the navmesh"), Movement->MovementMode.GetValue(), MOVE_NavWalking);
+
+	Movement->SetMovementLOD(EMovementLOD::Minimal);
+	TestEqual(TEXT("Minimal tier ignores pawns"), Capsule->GetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn), ECR_Ignore);
+
+	Movement->SetMovementLOD(EMovementLOD::Reduced);
+	TestEqual(TEXT("Leaving the minimal tier restores the pawn response"),
+		Capsule->GetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn), ECR_Overlap);
+
+	Movement->SetMovementLOD(EMovementLOD::Full);
+	TestEqual(TEXT("Full tier returns to the default land mode"), Movement->MovementMode.GetValue(), MOVE_Flying);
+	TestEqual(TEXT("Pawn response survives the round trip"),
+		Capsule->GetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn), ECR_Overlap);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMovementLODBenchmark, "ProjectR.Movement.LOD.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FMovementLODBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace MovementLODTest;
+
+	FCombatTestWorld World;
+	auto* Subsystem = UMovementLODSubsystem::Get(World.Get());
+	if (!TestNotNull(TEXT("Movement LOD subsystem"), Subsystem))
+		return false;
+
+	const float Width = Columns * Spacing;
+	const float Depth = MobNum / Columns * Spacing;
+	AActor* Floor = World.SpawnBox(FVector{ Width * 0.5f, Depth * 0.5f, -10.0f }, FVector{ Width, Depth, 10.0f });
+
+	// One player in a corner, so the mobs spread over every tier.
+	APRCharacter* Player = SpawnCharacter(World, FVector{ 0.0f, 0.0f, 200.0f });
+	auto* Controller = World->SpawnActor<APlayerController>();
+	if (!TestNotNull(TEXT("Player"), Player) || !TestNotNull(TEXT("Player controller"), Controller))
+		return false;
+
+	Controller->Possess(Player);
+	Controller->SetControlRotation(FRotator{ 0.0f, 45.0f, 0.0f });
+
+	const FBox Bounds{ FVector{ -Spacing, -Spacing, -500.0f }, FVector{ Width + Spacing, Depth + Spacing, 500.0f } };
+	const bool bHasNavMesh = BuildNavMesh(World, Bounds, *Floor, *Player);
+	if (!bHasNavMesh)
+		AddWarning(TEXT("No navmesh was built, the reduced tiers will walk instead"));
+
+	TArray<APRCharacter*> Mobs;
+	for (int32 Idx = 0; Idx < MobNum; ++Idx)
+	{
+		APRCharacter* Mob = SpawnCharacter(World, FVector{ (Idx % Columns + 0.5f) * Spacing, (Idx / Columns + 0.5f) * Spacing, 200.0f });
+		if (!Mob) continue;
+
+		// Mobs have no AI controller here, so movement is told to run without one.
+		GetMovement(Mob)->bRunPhysicsWithNoController = true;
+		Mobs.Add(Mob);
+	}
+
+	TestEqual(TEXT("Every mob spawned"), Mobs.Num(), MobNum);
+
+	// Baseline with every mob outside the subsystem at full fidelity.
+	for (APRCharacter* Mob : Mobs)
+	{
+		Subsystem->Unregister(Mob);
+		GetMovement(Mob)->SetMovementLOD(EMovementLOD::Full);
+	}
+
+	World.Tick();
+	const double FullTime = RunFrames(World, Mobs);
+
+	for (APRCharacter* Mob : Mobs)
+		Subsystem->Register(Mob);
+
+	// Lets the subsystem run its first update before measuring.
+	for (int32 Frame = 0; Frame < 60; ++Frame)
+		World.Tick();
+
+	int32 TierNums[3] = { 0, 0, 0 };
+	for (const APRCharacter* Mob : Mobs)
+		++TierNums[static_cast<int32>(GetMovement(Mob)->GetMovementLOD())];
+
+	TestTrue(TEXT("Mobs spread over the reduced tiers"), TierNums[1] > 0 && TierNums[2] > 0);
+	TestTrue(TEXT("The player stays at full fidelity"), GetMovement(Player)->GetMovementLOD() == EMovementLOD::Full);
+
+	const double LODTime = RunFrames(World, Mobs);
+
+	int32 NavWalkingNum = 0;
+	for (const APRCharacter* Mob : Mobs)
+		if (GetMovement(Mob)->MovementMode == MOVE_NavWalking)
+			++NavWalkingNum;
+
+	TestTrue(TEXT("The reduced tiers nav walk"), !bHasNavMesh || NavWalkingNum > 0);
+
+	// Without a navmesh the reduced tiers fall back to walking, so the numbers measure the lower tick rates alone.
+	const TCHAR* Label = bHasNavMesh ? TEXT("nav walking") : TEXT("tick rate only, no navmesh");
+	AddInfo(FString::Printf(TEXT("%d mobs, all full: %.3f ms per frame"), MobNum, FullTime));
+	AddInfo(FString::Printf(TEXT("%d mobs, %d full, %d reduced, %d minimal, %d nav walking (%s): %.3f ms per frame"),
+		MobNum, TierNums[0], TierNums[1], TierNums[2], NavWalkingNum, Label, LODTime));
+
+	return true;
+}
+
+#endif
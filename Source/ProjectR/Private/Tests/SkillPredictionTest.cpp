@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Component/WeaponComponent.h"
+#include "Framework/PRCharacter.h"
+#include "Misc/SkillPredictionQueue.h"
+#include "Skill/Skill.h"
+#include "Subsystem/CombatDataSubsystem.h"
+#include "Tests/CombatTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SkillPredictionTest
+{
+	// Confirmations travel one round trip of 200 ms at 60 fps.
+	constexpr int32 RoundTripFrames = 12;
+
+	struct FConfirm
+	{
+		int32 Frame;
+		uint16 Sequence;
+		bool bIsAccepted;
+	};
+
+	// Delivers every confirmation due by Frame, like ClientConfirmSkill arriving under lag.
+	void Deliver(FSkillPredictionQueue& Queue, TArray<FConfirm>& InFlight, int32 Frame, TArray<UAnimMontage*>& OutRolledBack)
+	{
+		while (InFlight.Num() > 0 && InFlight[0].Frame <= Frame)
+		{
+			Queue.Confirm(InFlight[0].Sequence, InFlight[0].bIsAccepted, OutRolledBack);
+			InFlight.RemoveAt(0);
+		}
+	}
+
+	// Finds a weapon whose first attack has a montage to predict.
+	bool FindPredictableWeapon(UCombatDataSubsystem& Registry, const APRCharacter* User, uint8& OutKey)
+	{
+		for (int32 Key = 0; Key < UCombatDataSubsystem::InvalidKey; ++Key)
+		{
+			const UWeapon* Weapon = Registry.GetWeapon(static_cast<uint8>(Key));
+			if (!Weapon) continue;
+
+			const int32 Node = Weapon->GetNextNode(INDEX_NONE, false);
+			const UClass* SkillClass = Weapon->GetSkillClass(Node);
+			const auto* SkillData = Registry.ResolveSkills(static_cast<uint8>(Key), 0u);
+			if (!SkillClass || !SkillData || !SkillData->IsValidIndex(Node))
+				continue;
+
+			if (SkillClass->GetDefaultObject<USkill>()->GetPredictedAnimation(User, (*SkillData)[Node]))
+			{
+				OutKey = static_cast<uint8>(Key);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Delivers the server's answer the way the RPC would, since a standalone world has no connection to carry it.
+	void ConfirmSkill(UWeaponComponent* Weapon, uint16 Sequence, bool bIsAccepted)
+	{
+		struct
+		{
+			uint16 Sequence;
+			bool bIsAccepted;
+		} Params{ Sequence, bIsAccepted };
+
+		Weapon->ProcessEvent(Weapon->FindFunctionChecked(TEXT("ClientConfirmSkill")), &Params);
+	}
+
+	void TickFrames(FCombatTestWorld& World, int32 FrameNum)
+	{
+		for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+			World.Tick();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSkillPredictionLagTest, "ProjectR.Combat.SkillPrediction.Lag",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSkillPredictionLagTest::RunTest(const FString& Parameters)
+{
+	using namespace SkillPredictionTest;
+
+	auto* First = NewObject<UAnimMontage>();
+	auto* Second = NewObject<UAnimMontage>();
+
+	FSkillPredictionQueue Queue;
+	TArray<FConfirm> InFlight;
+	TArray<UAnimMontage*> RolledBack;
+
+	// The first attack plays on its input frame, a full round trip before the server answers.
+	Queue.Add(First, 1u);
+	InFlight.Add(FConfirm{ RoundTripFrames, 1u, true });
+	TestTrue(TEXT("Montage plays on the input frame"), Queue.IsActive() && Queue.Contains(First));
+
+	// A combo input lands while the first one is still in flight and gets rejected.
+	Queue.Add(Second, 2u);
+	InFlight.Add(FConfirm{ 8 + RoundTripFrames, 2u, false });
+
+	for (int32 Frame = 0; Frame < RoundTripFrames; ++Frame)
+		Deliver(Queue, InFlight, Frame, RolledBack);
+
+	TestEqual(TEXT("Both inputs stay pending until the round trip"), Queue.GetPendingNum(), 2);
+
+	Deliver(Queue, InFlight, RoundTripFrames, RolledBack);
+	TestEqual(TEXT("Accepted input leaves the queue"), Queue.GetPendingNum(), 1);
+	TestEqual(TEXT("Acceptance rolls nothing back"), RolledBack.Num(), 0);
+
+	Deliver(Queue, InFlight, 8 + RoundTripFrames, RolledBack);
+	TestTrue(TEXT("Rejection rolls back the combo montage"), RolledBack.Num() == 1 && RolledBack[0] == Second);
+	TestFalse(TEXT("Rejection releases the prediction"), Queue.IsActive());
+	TestFalse(TEXT("Interrupt after a rollback is ignored"), Queue.End(Second, 2u));
+
+	// A server stop interrupts an already confirmed montage, which must still release the client.
+	Queue.Add(First, 3u);
+	Queue.Confirm(3u, true, RolledBack);
+	TestTrue(TEXT("Interrupt after confirmation releases the prediction"), Queue.End(First, 3u));
+	TestFalse(TEXT("Prediction is released"), Queue.IsActive());
+
+	// Replaying the same montage must not let the interrupt of the old one end the new one.
+	Queue.Add(First, 4u);
+	Queue.Add(First, 5u);
+	TestFalse(TEXT("Replaced prediction ignores its interrupt"), Queue.End(First, 4u));
+	TestTrue(TEXT("Newest prediction ends normally"), Queue.End(First, 5u));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSkillPredictionOwnerTest, "ProjectR.Combat.SkillPrediction.Owner",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FSkillPredictionOwnerTest::RunTest(const FString& Parameters)
+{
+	using namespace SkillPredictionTest;
+
+	FCombatTestWorld World;
+	auto* Registry = UCombatDataSubsystem::Get(World.Get());
+	auto* User = World->SpawnActor<APRCharacter>(FVector{ 0.0f, 0.0f, 200.0f }, FRotator::ZeroRotator);
+	if (!TestNotNull(TEXT("Combat data"), Registry) || !TestNotNull(TEXT("Character"), User))
+		return false;
+
+	uint8 Key = 0u;
+	if (!TestTrue(TEXT("Combat data has a weapon with a predicted attack"), FindPredictableWeapon(*Registry, User, Key)))
+		return false;
+
+	// The weapon is added with authority, then the character turns into the owner's proxy of it.
+	UWeaponComponent* Weapon = User->GetWeaponComponent();
+	Weapon->AddWeapon(Key);
+
+	// The character mesh and its anim class load asynchronously.
+	FlushAsyncLoading();
+	TickFrames(World, 2);
+
+	UAnimInstance* AnimInstance = User->GetMesh()->GetAnimInstance();
+	if (!TestNotNull(TEXT("Anim instance"), AnimInstance))
+		return false;
+
+	User->SetRole(ENetRole::ROLE_AutonomousProxy);
+
+	// Server RPCs go nowhere in a standalone world, so only the local prediction can start the montage.
+	Weapon->Attack(false);
+	UAnimMontage* First = AnimInstance->GetCurrentActiveMontage();
+	TestTrue(TEXT("Attack plays the montage on the input frame"), First && AnimInstance->Montage_IsPlaying(First));
+	TestTrue(TEXT("The montage is the predicted one"), Weapon->IsPredictedAnimation(First));
+
+	TickFrames(World, RoundTripFrames - 1);
+	TestTrue(TEXT("The montage keeps playing until the server answers"), First && AnimInstance->Montage_IsPlaying(First));
+
+	ConfirmSkill(Weapon, 1u, true);
+	TestTrue(TEXT("Acceptance leaves the montage alone"), First && AnimInstance->Montage_IsPlaying(First));
+
+	// Ends the accepted attack, so the next one starts from an idle character.
+	AnimInstance->Montage_Stop(0.0f, First);
+	TickFrames(World, 2);
+
+	Weapon->Attack(false);
+	UAnimMontage* Second = AnimInstance->GetCurrentActiveMontage();
+	TestTrue(TEXT("The next attack predicts as well"), Second && Weapon->IsPredictedAnimation(Second));
+
+	ConfirmSkill(Weapon, 2u, false);
+	TickFrames(World, 2);
+	TestFalse(TEXT("Rejection rolls the montage back"), Second && AnimInstance->Montage_IsPlaying(Second));
+	TestFalse(TEXT("Rejection releases the prediction"), Weapon->IsPredictedAnimation(Second));
+
+	Weapon->Attack(false);
+	UAnimMontage* Third = AnimInstance->GetCurrentActiveMontage();
+	TestTrue(TEXT("The owner predicts again after a rollback"), Third && AnimInstance->Montage_IsPlaying(Third));
+
+	return true;
+}
+
+#endif
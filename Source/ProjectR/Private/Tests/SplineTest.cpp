@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Spline.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SplineTest
+{
+	constexpr float Tolerance = 0.01f;
+
+	// USpline::Compute before the curve library, kept as the reference for the uniform parameterization.
+	FVector ComputeLegacy(const TArray<FVector>& Points, int32 Idx, float Alpha)
+	{
+		const FVector& P0 = Points[Idx - 1];
+		const FVector& P1 = Points[Idx];
+		const FVector& P2 = Points[Idx + 1];
+		const FVector& P3 = Points[Idx + 2];
+
+		return 0.5f * ((2.0f * P1) + (-P0 + P2) * Alpha +
+			(2.0f * P0 - 5.0f * P1 + 4.0f * P2 - P3) * Alpha * Alpha +
+			(-P0 + 3.0f * P1 - 3.0f * P2 + P3) * Alpha * Alpha * Alpha);
+	}
+
+	TArray<FVector> MakePoints(FRandomStream& Random, int32 Num)
+	{
+		TArray<FVector> Points;
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+			Points.Add(FVector{ Idx * 300.0f, 0.0f, 0.0f } + Random.GetUnitVector() * Random.FRandRange(0.0f, 250.0f));
+
+		return Points;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineUniformTest, "ProjectR.Misc.Spline.Uniform",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSplineUniformTest::RunTest(const FString& Parameters)
+{
+	using namespace SplineTest;
+
+	FRandomStream Random{ 16 };
+	int32 MismatchNum = 0;
+
+	for (int32 Case = 0; Case < 256; ++Case)
+	{
+		const TArray<FVector> Points = MakePoints(Random, 5);
+		for (int32 Idx = 1; Idx <= 2; ++Idx)
+			for (int32 Step = 0; Step <= 8; ++Step)
+			{
+				const float Alpha = Step / 8.0f;
+				MismatchNum += !FSplineCurve::Compute(Points, Idx, Alpha, 0.0f).Equals(ComputeLegacy(Points, Idx, Alpha), Tolerance);
+			}
+	}
+
+	TestEqual(TEXT("Uniform parameterization matches the original Catmull-Rom"), MismatchNum, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineBatchTest, "ProjectR.Misc.Spline.Batch",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSplineBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace SplineTest;
+
+	FRandomStream Random{ 17 };
+	FSplineCurve Curve;
+	Curve.Build(MakePoints(Random, 8), 0.5f);
+
+	// One sample past the end and a count that is not a multiple of four.
+	constexpr int32 SampleNum = 101;
+	TArray<float> Distances;
+	for (int32 Idx = 0; Idx < SampleNum; ++Idx)
+		Distances.Add(Curve.GetLength() * Idx / (SampleNum - 2));
+
+	TArray<FVector> Points;
+	Points.SetNum(SampleNum);
+	Curve.ComputeBatch(Distances, Points);
+
+	int32 MismatchNum = 0;
+	for (int32 Idx = 0; Idx < SampleNum; ++Idx)
+	{
+		FVector Expected;
+		Curve.ComputeAtDistance(Distances[Idx], Expected);
+		MismatchNum += !Points[Idx].Equals(Expected, Tolerance);
+	}
+
+	TestEqual(TEXT("Ascending batch matches single evaluation"), MismatchNum, 0);
+
+	// Equal arc-length steps should come out as equal chords.
+	const float Chord = Curve.GetLength() / (SampleNum - 2);
+	int32 UnevenNum = 0;
+	for (int32 Idx = 1; Idx < SampleNum - 1; ++Idx)
+		UnevenNum += !FMath::IsNearlyEqual(FVector::Dist(Points[Idx - 1], Points[Idx]), Chord, Chord * 0.1f);
+
+	TestEqual(TEXT("Arc-length samples are evenly spaced"), UnevenNum, 0);
+
+	// Unordered distances fall back to the search.
+	Random.Initialize(18);
+	for (int32 Idx = SampleNum - 1; Idx > 0; --Idx)
+		Distances.Swap(Idx, Random.RandRange(0, Idx));
+
+	Curve.ComputeBatch(Distances, Points);
+
+	MismatchNum = 0;
+	for (int32 Idx = 0; Idx < SampleNum; ++Idx)
+	{
+		FVector Expected;
+		Curve.ComputeAtDistance(Distances[Idx], Expected);
+		MismatchNum += !Points[Idx].Equals(Expected, Tolerance);
+	}
+
+	TestEqual(TEXT("Shuffled batch matches single evaluation"), MismatchNum, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineBenchmark, "ProjectR.Misc.Spline.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSplineBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace SplineTest;
+
+	constexpr int32 SampleNum = 100000;
+
+	// A leap path has two segments.
+	FRandomStream Random{ 19 };
+	const TArray<FVector> Points = MakePoints(Random, 5);
+
+	FSplineCurve Curve;
+	Curve.Build(Points, 0.5f);
+
+	TArray<float> Distances;
+	TArray<FVector> Batch;
+	Distances.SetNumUninitialized(SampleNum);
+	Batch.SetNumUninitialized(SampleNum);
+	for (int32 Idx = 0; Idx < SampleNum; ++Idx)
+		Distances[Idx] = Curve.GetLength() * Idx / SampleNum;
+
+	const auto ToNs = [](double Seconds) { return Seconds * 1000000000.0 / SampleNum; };
+	FVector Sum = FVector::ZeroVector;
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Idx = 0; Idx < SampleNum; ++Idx)
+		Sum += ComputeLegacy(Points, 1 + Idx * 2 / SampleNum, (Idx * 2 % SampleNum) / static_cast<float>(SampleNum));
+	const double LegacyTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Idx = 0; Idx < SampleNum; ++Idx)
+		Sum += FSplineCurve::Compute(Points, 1 + Idx * 2 / SampleNum, (Idx * 2 % SampleNum) / static_cast<float>(SampleNum), 0.5f);
+	const double ComputeTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Idx = 0; Idx < SampleNum; ++Idx)
+	{
+		FVector Point;
+		Curve.ComputeAtDistance(Distances[Idx], Point);
+		Sum += Point;
+	}
+	const double DistanceTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	Curve.ComputeBatch(Distances, Batch);
+	const double BatchTime = FPlatformTime::Seconds() - StartTime;
+	Sum += Batch.Last();
+
+	TestFalse(TEXT("Samples are finite"), Sum.ContainsNaN());
+
+	AddInfo(FString::Printf(TEXT("Legacy Compute: %.1f ns per sample"), ToNs(LegacyTime)));
+	AddInfo(FString::Printf(TEXT("Centripetal Compute: %.1f ns per sample"), ToNs(ComputeTime)));
+	AddInfo(FString::Printf(TEXT("ComputeAtDistance: %.1f ns per sample"), ToNs(DistanceTime)));
+	AddInfo(FString::Printf(TEXT("ComputeBatch: %.1f ns per sample"), ToNs(BatchTime)));
+
+	return true;
+}
+
+#endif
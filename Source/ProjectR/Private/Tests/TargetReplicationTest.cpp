@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitWriter.h"
+#include "Component/TargetComponent.h"
+#include "Framework/PRCharacter.h"
+#include "Framework/PRPlayerController.h"
+#include "Tests/CombatTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TargetReplicationTest
+{
+	constexpr int32 EnemyNum = 300;
+	constexpr int32 Columns = 30;
+	constexpr float Spacing = 300.0f;
+	constexpr float WalkSpeed = 600.0f;
+	constexpr float FrameRate = 30.0f;
+
+	// Object references go out as packed NetGUIDs once the client has acknowledged them, as the package map writes them.
+	void WriteReference(FBitWriter& Writer, const TMap<const AActor*, uint32>& Guids, const AActor* Actor)
+	{
+		uint32 Guid = Actor ? Guids.FindRef(Actor) : 0u;
+		Writer.SerializeIntPacked(Guid);
+	}
+
+	// Property handle, then the array size when it changed, then the handle and value of every changed element.
+	int64 MeasureArray(const TArray<AActor*>& Old, const TArray<AActor*>& New, const TMap<const AActor*, uint32>& Guids)
+	{
+		FBitWriter Writer{ 0, true };
+		uint32 Handle = 1u;
+		Writer.SerializeIntPacked(Handle);
+
+		if (Old.Num() != New.Num())
+		{
+			uint16 Num = static_cast<uint16>(New.Num());
+			Writer << Num;
+		}
+
+		for (int32 Idx = 0; Idx < New.Num(); ++Idx)
+		{
+			if (Old.IsValidIndex(Idx) && Old[Idx] == New[Idx])
+				continue;
+
+			uint32 ElementHandle = static_cast<uint32>(Idx + 1);
+			Writer.SerializeIntPacked(ElementHandle);
+			WriteReference(Writer, Guids, New[Idx]);
+		}
+
+		return Writer.GetNumBits();
+	}
+
+	int64 MeasureReference(const AActor* New, const TMap<const AActor*, uint32>& Guids)
+	{
+		FBitWriter Writer{ 0, true };
+		uint32 Handle = 1u;
+		Writer.SerializeIntPacked(Handle);
+		WriteReference(Writer, Guids, New);
+		return Writer.GetNumBits();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTargetReplicationBandwidthTest, "ProjectR.Combat.Targeting.Bandwidth",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FTargetReplicationBandwidthTest::RunTest(const FString& Parameters)
+{
+	using namespace TargetReplicationTest;
+
+	FCombatTestWorld World;
+
+	// A dense block of enemies the player walks straight through.
+	TMap<const AActor*, uint32> Guids;
+	for (int32 Idx = 0; Idx < EnemyNum; ++Idx)
+	{
+		const FVector Location{ (Idx % Columns) * Spacing, (Idx / Columns - Columns / 6) * Spacing, 100.0f };
+		if (const AActor* Enemy = World->SpawnActor<APRCharacter>(Location, FRotator::ZeroRotator))
+			Guids.Add(Enemy, static_cast<uint32>(Guids.Num() + 1));
+	}
+
+	const float StartX = -3000.0f;
+	const float EndX = Columns * Spacing + 3000.0f;
+
+	auto* Player = World->SpawnActor<APRCharacter>(FVector{ StartX, 0.0f, 100.0f }, FRotator::ZeroRotator);
+	auto* Controller = World->SpawnActor<APRPlayerController>();
+	UTargetComponent* Targeter = Controller ? Controller->FindComponentByClass<UTargetComponent>() : nullptr;
+	if (!TestNotNull(TEXT("Player"), Player) || !TestNotNull(TEXT("Targeter"), Targeter))
+		return false;
+
+	// Enemies spawn without a team, so the player only needs one of its own.
+	Player->SetGenericTeamId(FGenericTeamId{ 1 });
+	Controller->Possess(Player);
+	Controller->SetControlRotation(FRotator::ZeroRotator);
+
+	TArray<AActor*> LastCandidates;
+	const AActor* LastTarget = nullptr;
+	int64 ListBits = 0;
+	int64 TargetBits = 0;
+	int32 ListUpdateNum = 0;
+	int32 TargetUpdateNum = 0;
+	int32 MaxCandidateNum = 0;
+
+	const int32 FrameNum = FMath::CeilToInt((EndX - StartX) / WalkSpeed * FrameRate);
+	for (int32 Frame = 0; Frame < FrameNum; ++Frame)
+	{
+		Player->SetActorLocation(FVector{ StartX + Frame * WalkSpeed / FrameRate, 0.0f, 100.0f });
+		World.Tick(1.0f / FrameRate);
+
+		// The replicated candidate list, as every perception change used to send it.
+		const TArray<AActor*>& Candidates = Targeter->GetTargetActors();
+		if (Candidates != LastCandidates)
+		{
+			ListBits += MeasureArray(LastCandidates, Candidates, Guids);
+			LastCandidates = Candidates;
+			++ListUpdateNum;
+		}
+
+		MaxCandidateNum = FMath::Max(MaxCandidateNum, Candidates.Num());
+
+		// Only the selection replicates now, to the owner alone.
+		const AActor* Target = Targeter->GetTargetedActor();
+		if (Target != LastTarget)
+		{
+			TargetBits += MeasureReference(Target, Guids);
+			LastTarget = Target;
+			++TargetUpdateNum;
+		}
+	}
+
+	TestTrue(TEXT("The walk passes through the enemies"), MaxCandidateNum > 0);
+	TestTrue(TEXT("Replicating the selection alone costs less"), TargetBits < ListBits);
+
+	const float Seconds = FrameNum / FrameRate;
+	AddInfo(FString::Printf(TEXT("%.1f s walk past %d enemies, up to %d candidates in sight"), Seconds, EnemyNum, MaxCandidateNum));
+	AddInfo(FString::Printf(TEXT("Candidate list: %d updates, %lld bytes, %.1f bytes/s"),
+		ListUpdateNum, ListBits / 8, ListBits / 8.0f / Seconds));
+	AddInfo(FString::Printf(TEXT("Selected target: %d updates, %lld bytes, %.1f bytes/s"),
+		TargetUpdateNum, TargetBits / 8, TargetBits / 8.0f / Seconds));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectIterator.h"
+#include "Component/WeaponComponent.h"
+#include "Framework/PRCharacter.h"
+#include "Misc/Weapon.h"
+#include "Skill/Skill.h"
+#include "Subsystem/CombatDataSubsystem.h"
+#include "Tests/CombatTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace WeaponArchetypeTest
+{
+	constexpr int32 CharacterNum = 500;
+	constexpr int32 Columns = 25;
+	constexpr float Spacing = 300.0f;
+
+	// The first two keys the combat data knows, the loadout most mobs carry.
+	TArray<uint8> FindWeaponKeys(UCombatDataSubsystem& Registry)
+	{
+		TArray<uint8> Keys;
+		for (int32 Key = 0; Key < UCombatDataSubsystem::InvalidKey && Keys.Num() < 2; ++Key)
+			if (Registry.GetWeapon(static_cast<uint8>(Key)))
+				Keys.Add(static_cast<uint8>(Key));
+
+		return Keys;
+	}
+
+	template <class T>
+	int32 CountObjects()
+	{
+		int32 Num = 0;
+		for (TObjectIterator<T> It; It; ++It)
+			if (!It->IsTemplate())
+				++Num;
+
+		return Num;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponArchetypeObjectCountTest, "ProjectR.Combat.Weapon.ObjectCount",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FWeaponArchetypeObjectCountTest::RunTest(const FString& Parameters)
+{
+	using namespace WeaponArchetypeTest;
+
+	FCombatTestWorld World;
+	auto* Registry = UCombatDataSubsystem::Get(World.Get());
+	if (!TestNotNull(TEXT("Combat data"), Registry))
+		return false;
+
+	const TArray<uint8> Keys = FindWeaponKeys(*Registry);
+	if (!TestTrue(TEXT("Combat data has weapons"), Keys.Num() > 0))
+		return false;
+
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// Archetypes are built on first use, so one character builds them before the baseline.
+	auto* First = World->SpawnActor<APRCharacter>(FVector{ 0.0f, -Spacing, 200.0f }, FRotator::ZeroRotator, Params);
+	if (!TestNotNull(TEXT("Character"), First))
+		return false;
+
+	for (const uint8 Key : Keys)
+		First->GetWeaponComponent()->AddWeapon(Key);
+
+	World.Tick();
+
+	const int32 ObjectNumBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const int32 WeaponNumBefore = CountObjects<UWeapon>();
+	const int32 SkillNumBefore = CountObjects<USkill>();
+
+	int32 SpawnedNum = 0;
+	for (int32 Idx = 0; Idx < CharacterNum; ++Idx)
+	{
+		const FVector Location{ (Idx % Columns) * Spacing, (Idx / Columns) * Spacing, 200.0f };
+		auto* Character = World->SpawnActor<APRCharacter>(Location, FRotator::ZeroRotator, Params);
+		if (!Character) continue;
+
+		for (const uint8 Key : Keys)
+			Character->GetWeaponComponent()->AddWeapon(Key);
+
+		++SpawnedNum;
+	}
+
+	World.Tick();
+
+	const int32 ObjectNumAfter = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const int32 WeaponNum = CountObjects<UWeapon>() - WeaponNumBefore;
+	const int32 SkillNum = CountObjects<USkill>() - SkillNumBefore;
+
+	TestEqual(TEXT("Every character spawned"), SpawnedNum, CharacterNum);
+	TestEqual(TEXT("Characters share the weapon archetypes"), WeaponNum, 0);
+	TestTrue(TEXT("Pooled skills stay within three per character"), SkillNum <= SpawnedNum * 3);
+
+	AddInfo(FString::Printf(TEXT("%d characters with %d weapons each"), SpawnedNum, Keys.Num()));
+	AddInfo(FString::Printf(TEXT("UObjects: %d before, %d after, %.1f per character"),
+		ObjectNumBefore, ObjectNumAfter, static_cast<float>(ObjectNumAfter - ObjectNumBefore) / FMath::Max(SpawnedNum, 1)));
+	AddInfo(FString::Printf(TEXT("New UWeapon: %d, new USkill: %d"), WeaponNum, SkillNum));
+
+	return true;
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Data/MoveState.h"
+#include "Data/MovementLOD.h"
 #include "PRMovementComponent.generated.h"
 
 UCLASS()
@@ -28,10 +29,26 @@ public:
 
 	void ApplyLock(bool bIsLock);
 
+	// Trades simulation fidelity for cost on the server; see EMovementLOD.
+	void SetMovementLOD(EMovementLOD NewLOD);
+
+	// While set, the character turns to face Target as part of its movement update.
+	FORCEINLINE void SetLockTarget(AActor* Target) noexcept { LockTarget = Target; }
+
+	// Flies the path as a root motion source. The server and the predicting owner start it on their own,
+	// and character movement reconciles the owner and replicates it to simulated proxies.
+	void StartLeap(const TArray<FVector>& Points, float Duration, float FirstRatio);
+	void StopLeap();
+
+	FORCEINLINE const TArray<FVector>& GetLeapPoints() const noexcept { return LeapPoints; }
+	FORCEINLINE uint32 GetLeapPathKey() const noexcept { return LeapPathKey; }
+
 	FORCEINLINE float GetRunSpeed() const noexcept { return RunSpeed; }
 	FORCEINLINE float GetWalkSpeed() const noexcept { return WalkSpeed; }
 	FORCEINLINE float GetLockSpeed() const noexcept { return LockSpeed; }
 	FORCEINLINE EMoveState GetMoveState() const noexcept { return MoveState; }
+	FORCEINLINE bool IsLockApplied() const noexcept { return bIsLocked; }
+	FORCEINLINE EMovementLOD GetMovementLOD() const noexcept { return MovementLOD; }
 
 private:
 	void BeginPlay() override;
@@ -41,8 +58,13 @@ private:
 
 	FVector ConsumeInputVector() override;
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSetLastInputVector(FVector InLastInputVector);
+	void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+	void PhysicsRotation(float DeltaTime) override;
+
+	void UpdateFromCompressedFlags(uint8 Flags) override;
+	void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+	bool ClientUpdatePositionAfterServerUpdate() override;
+	class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerSetRunSpeed(float InRunSpeed);
@@ -53,15 +75,6 @@ private:
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerSetLockSpeed(float InLockSpeed);
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSetMoveState(EMoveState NewMoveState);
-
-	FORCEINLINE void ServerSetLastInputVector_Implementation
-		(FVector InLastInputVector) noexcept { LastInputVector = InLastInputVector;	}
-
-	FORCEINLINE bool ServerSetLastInputVector_Validate
-		(FVector InLastInputVector) const noexcept { return true; }
-
 	void ServerSetRunSpeed_Implementation(float InRunSpeed);
 	FORCEINLINE bool ServerSetRunSpeed_Validate
 		(float InRunSpeed) const noexcept { return true; }
@@ -74,9 +87,11 @@ private:
 	FORCEINLINE bool ServerSetLockSpeed_Validate
 		(float InLockSpeed) const noexcept { return true; }
 
-	void ServerSetMoveState_Implementation(EMoveState NewMoveState);
-	FORCEINLINE bool ServerSetMoveState_Validate
-		(EMoveState NewMoveState) const noexcept { return true; }
+	// Sends the server's path once, which the owner's predicted leap switches to and simulated proxies fly.
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastStartLeap(const TArray<FVector_NetQuantize10>& Points, float Duration, float FirstRatio);
+
+	void MulticastStartLeap_Implementation(const TArray<FVector_NetQuantize10>& Points, float Duration, float FirstRatio);
 
 	UFUNCTION()
 	void OnRep_RunSpeed();
@@ -114,6 +129,54 @@ private:
 		BlueprintSetter = SetMoveState, meta = (AllowPrivateAccess = true))
 	EMoveState MoveState;
 
+	UPROPERTY(EditAnywhere, Category = Lock, meta = (AllowPrivateAccess = true))
+	float LockRotationSpeed;
+
+	TWeakObjectPtr<AActor> LockTarget;
+
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (AllowPrivateAccess = true))
+	float ReducedTickInterval;
+
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (AllowPrivateAccess = true))
+	float MinimalTickInterval;
+
+	EMovementLOD MovementLOD;
+
+	// Response of the capsule to pawns before the minimal tier cleared it.
+	TEnumAsByte<ECollisionResponse> SavedPawnResponse;
+
+	uint16 LeapSourceId;
+
+	// Last path received from the server, kept for the sources root motion updates bring in without points.
+	TArray<FVector> LeapPoints;
+	uint32 LeapPathKey;
+
 	UPROPERTY(Transient)
 	uint8 bIsLocked : 1;
 };
+
+class PROJECTR_API FSavedMove_PR : public FSavedMove_Character
+{
+public:
+	using Super = FSavedMove_Character;
+
+	void Clear() override;
+	uint8 GetCompressedFlags() const override;
+	bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	void SetMoveFor(ACharacter* InCharacter, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	void PrepMoveFor(ACharacter* InCharacter) override;
+
+private:
+	uint8 bSavedIsLocked : 1;
+	uint8 bSavedIsRunning : 1;
+};
+
+class PROJECTR_API FNetworkPredictionData_Client_PR : public FNetworkPredictionData_Client_Character
+{
+public:
+	using Super = FNetworkPredictionData_Client_Character;
+
+	explicit FNetworkPredictionData_Client_PR(const UCharacterMovementComponent& ClientMovement);
+
+	FSavedMovePtr AllocateNewMove() override;
+};
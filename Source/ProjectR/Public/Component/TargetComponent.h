@@ -4,7 +4,6 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
-#include "Perception/AIPerceptionTypes.h"
 #include "TargetComponent.generated.h"
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
@@ -14,17 +13,31 @@ class PROJECTR_API UTargetComponent final : public UActorComponent
 
 public:
 	UTargetComponent();
-	
-	void Initialize(class UAIPerceptionComponent* Perception);
 
 	UFUNCTION(BlueprintSetter)
 	void SetInterval(float InInterval);
 
+	// Called by the targeting subsystem with the hostile characters in sight.
+	void UpdateCandidates(const TArray<AActor*>& Candidates, float Now);
+
+	// Called every frame between updates, rescores the current candidates once the view turned past RescoreAngle.
+	void UpdateView();
+
+	void GetView(FVector& OutLocation, FRotator& OutRotation) const;
+
+	// Drops a candidate that is gone, e.g. dead, and picks the best remaining one right away.
+	void RemoveCandidate(AActor* Candidate);
+
 	FORCEINLINE AActor* GetTargetedActor() const noexcept { return TargetedActor; }
+	FORCEINLINE const TArray<AActor*>& GetTargetActors() const noexcept { return TargetActors; }
+	FORCEINLINE float GetSightRadius() const noexcept { return SightRadius; }
+	FORCEINLINE float GetSightAngle() const noexcept { return SightAngle; }
+	FORCEINLINE bool IsUpdateDue(float Now) const noexcept { return Now >= NextUpdateTime; }
+	FORCEINLINE void RequestUpdate() noexcept { NextUpdateTime = 0.0f; }
 
 private:
 	void BeginPlay() override;
-	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UFUNCTION(Server, Reliable, WithValidation)
@@ -33,16 +46,53 @@ private:
 	void ServerSetInterval_Implementation(float InInterval);
 	FORCEINLINE bool ServerSetInterval_Validate(float InInterval) { return InInterval > 0.0f; }
 
-	UFUNCTION()
-	void OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus);
+	// Scores every candidate four at a time and targets the lowest score.
+	void ScoreTargets(const FVector& Location, const FRotator& Rotation);
 
 private:
-	UPROPERTY(Replicated, Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	// Only the server selects targets, so the candidates never leave it.
+	UPROPERTY(Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TArray<AActor*> TargetActors;
 
-	UPROPERTY(Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	UPROPERTY(Replicated, Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	AActor* TargetedActor;
 
 	UPROPERTY(Replicated, EditAnywhere, BlueprintSetter = SetInterval, meta = (AllowPrivateAccess = true))
 	float Interval;
+
+	// Replaces the sight sense radius of the former perception component.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Sight, meta = (AllowPrivateAccess = true, ClampMin = 0.0))
+	float SightRadius;
+
+	// Half angle of the view cone in degrees, the former peripheral vision angle.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Sight, meta = (AllowPrivateAccess = true, ClampMin = 0.0, ClampMax = 180.0))
+	float SightAngle;
+
+	UPROPERTY(EditAnywhere, Category = Score, meta = (AllowPrivateAccess = true))
+	float AngleWeight;
+
+	UPROPERTY(EditAnywhere, Category = Score, meta = (AllowPrivateAccess = true))
+	float DistanceWeight;
+
+	// Bonus for candidates that are locked on the owner.
+	UPROPERTY(EditAnywhere, Category = Score, meta = (AllowPrivateAccess = true))
+	float ThreatWeight;
+
+	// Distance that costs as much as DistanceWeight.
+	UPROPERTY(EditAnywhere, Category = Score, meta = (AllowPrivateAccess = true))
+	float DistanceScale;
+
+	// Yaw in degrees the view turns before candidates are scored again.
+	UPROPERTY(EditAnywhere, Category = Score, meta = (AllowPrivateAccess = true))
+	float RescoreAngle;
+
+	// Candidate lanes, padded to a multiple of four.
+	TArray<float> CandidateX;
+	TArray<float> CandidateY;
+	TArray<float> Threats;
+	TArray<float> Scores;
+
+	float ScoredYaw;
+	float NextUpdateTime;
+	uint8 bIsDirty : 1;
 };
@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Data/CombatInput.h"
 #include "Data/CombatState.h"
 #include "Data/VisualData.h"
+#include "Misc/SkillPredictionQueue.h"
+#include "Misc/Weapon.h"
 #include "WeaponComponent.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnAttack);
@@ -67,11 +70,13 @@ public:
 
 	FORCEINLINE const FAnimData& GetAnimData() const noexcept { return VisualData.AnimData; }
 	FORCEINLINE float GetWeaponSwapDuration() const noexcept { return WeaponSwapDuration; }
-	FORCEINLINE int32 GetWeaponNum() const noexcept { return Weapons.Num(); }
+	FORCEINLINE int32 GetWeaponNum() const noexcept { return Keies.Num(); }
 	FORCEINLINE uint8 GetWeaponIndex() const noexcept { return WeaponIndex; }
 	FORCEINLINE bool IsCheckingCombo() const noexcept { return bNowCombo; }
 	FORCEINLINE bool IsBlockSkill() const noexcept { return bBlockSkill; }
 
+	bool IsPredictedAnimation(const class UAnimMontage* Animation) const noexcept;
+
 private:
 #if WITH_EDITOR
 	void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -80,59 +85,76 @@ private:
 	void InitializeComponent() override;
 	void BeginPlay() override;
 	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
-
-	void TickComponent(float DeltaTime, ELevelTick TickType,
-		FActorComponentTickFunction* ThisTickFunction) override;
 	
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerAttack(bool bIsStrongAttack);
-
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerDodge();
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerSendInputs(const TArray<FCombatInput>& Inputs);
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerStopSkill();
 
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSwapWeapon(uint8 Index);
+	void ServerChangeWeapon(uint8 Index, uint8 Key);
 
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerChangeWeapon(uint8 Index, int32 Key);
-
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerAddWeapon(int32 Key);
+	void ServerAddWeapon(uint8 Key);
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerSetLevel(uint8 InLevel);
 
-	void ServerAttack_Implementation(bool bIsStrongAttack);
-	FORCEINLINE bool ServerAttack_Validate(bool bIsStrongAttack) const noexcept { return true; }
+	UFUNCTION(Client, Reliable)
+	void ClientConfirmSkill(uint16 Sequence, bool bIsAccepted);
 
-	void ServerDodge_Implementation();
-	FORCEINLINE bool ServerDodge_Validate() const noexcept { return true; }
+	void ServerSendInputs_Implementation(const TArray<FCombatInput>& Inputs);
+	FORCEINLINE bool ServerSendInputs_Validate(const TArray<FCombatInput>& Inputs) const noexcept { return Inputs.Num() <= MaxInputNum; }
 
 	void ServerStopSkill_Implementation();
 	FORCEINLINE bool ServerStopSkill_Validate() const noexcept { return true; }
 
-	void ServerSwapWeapon_Implementation(uint8 Index);
-	FORCEINLINE bool ServerSwapWeapon_Validate(uint8 Index) const noexcept { return Weapons.Num() > Index; }
+	void ServerChangeWeapon_Implementation(uint8 Index, uint8 Key);
+	FORCEINLINE bool ServerChangeWeapon_Validate(uint8 Index, uint8 Key) const noexcept { return true; }
 
-	void ServerChangeWeapon_Implementation(uint8 Index, int32 Key);
-	FORCEINLINE bool ServerChangeWeapon_Validate(uint8 Index, int32 Key) const noexcept { return true; }
-
-	void ServerAddWeapon_Implementation(int32 Key);
-	FORCEINLINE bool ServerAddWeapon_Validate(int32 Key) const noexcept { return true; }
+	void ServerAddWeapon_Implementation(uint8 Key);
+	FORCEINLINE bool ServerAddWeapon_Validate(uint8 Key) const noexcept { return true; }
 
 	void ServerSetLevel_Implementation(uint8 InLevel);
 	FORCEINLINE bool ServerSetLevel_Validate(uint8 InLevel) const noexcept { return InLevel < 10; }
 
-	void EquipWeapon(class UWeapon* NewWeapon);
+	void ClientConfirmSkill_Implementation(uint16 Sequence, bool bIsAccepted);
+
+	void AddInput(ECombatInputType Type, uint8 Index = 0u);
+	void FlushInputs();
+
+	// Buffers at most MaxInputNum inputs on the server, dropping the oldest.
+	void BufferInput(const FCombatInput& Input);
+
+	// Runs buffered inputs in order, waiting for the combo window and dropping expired ones.
+	void ConsumeInputs();
+	bool CanExecuteInput(const FCombatInput& Input) const noexcept;
+	bool ExecuteInput(const FCombatInput& Input);
+
+	// Plays the montage of the next node on the owning client before the server confirms it.
+	bool PredictSkill(ECombatState NewState, bool bIsStrongAttack, uint16 Sequence);
+	void OnPredictedMontageEnded(class UAnimMontage* Montage, bool bInterrupted, uint16 Sequence);
+	void EndPrediction();
+
+	void EquipWeapon(UWeapon* NewWeapon);
+	void LoadVisualData(UWeapon* Weapon);
+	void OnWeaponLoaded(UWeapon* Weapon);
 	void Initialize();
 
+	bool MakeWeaponState(uint8 Key, FWeaponState& OutState);
+	void BeginSkill(int32 Node);
+	class USkill* GetSkillInstance(UClass* SkillClass);
+
+	void ApplyVisualData();
+
+	UFUNCTION()
+	void OnRep_EquippedKey();
+
 	UFUNCTION()
-	void OnRep_VisualData();
+	void OnRep_Loadout();
 
 	UFUNCTION()
 	void Detach();
@@ -154,12 +176,20 @@ public:
 	FOnDisableCombo OnDisableCombo;
 
 private:
-	UPROPERTY(EditAnywhere, Category = Data, meta = (AllowPrivateAccess = true))
+	static constexpr int32 MaxInputNum = 16;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Loadout, EditAnywhere, Category = Data, meta = (AllowPrivateAccess = true))
 	TArray<uint8> Keies;
 
 	UPROPERTY(EditAnywhere, Category = Data, meta = (AllowPrivateAccess = true, ClmapMin = "0.01"))
 	float WeaponSwapDuration;
 
+	UPROPERTY(EditAnywhere, Category = Data, meta = (AllowPrivateAccess = true, ClampMin = "0.0"))
+	float InputBufferTime;
+
+	UPROPERTY(EditAnywhere, Category = Data, meta = (AllowPrivateAccess = true, ClampMin = "0.01"))
+	float InputResendInterval;
+
 	UPROPERTY(Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	UWeaponMeshComponent* RightWeapon;
 
@@ -167,15 +197,18 @@ private:
 	UWeaponMeshComponent* LeftWeapon;
 
 	UPROPERTY(Transient)
-	TArray<UWeapon*> Weapons;
+	TArray<FWeaponState> Weapons;
+
+	UPROPERTY(Transient)
+	TMap<UClass*, USkill*> SkillInstances;
 
 	UPROPERTY(Transient)
-	UWeapon* NoWeapon;
+	USkill* ActiveSkill;
 	
 	UPROPERTY(Transient)
 	class USkillContext* SkillContext;
 
-	UPROPERTY(ReplicatedUsing = OnRep_VisualData, Transient)
+	UPROPERTY(Transient)
 	FVisualData VisualData;
 
 	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
@@ -184,12 +217,39 @@ private:
 	UPROPERTY(Replicated, EditDefaultsOnly, BlueprintSetter = SetLevel, meta = (AllowPrivateAccess = true))
 	uint8 Level;
 
+	FSkillPredictionQueue Predictions;
+
+	// Default object of the skill the owner is predicting right now.
+	const USkill* PredictedSkill;
+
+	TArray<FCombatInput> PendingInputs;
+	TArray<FCombatInput> InputBuffer;
+
+	// Kept apart, as a listen server's own resends would otherwise cancel its buffered consume.
+	FTimerHandle FlushTimer;
+	FTimerHandle ConsumeTimer;
+
+	// Smallest server minus client time seen, which maps client timestamps onto the server clock.
+	float ClientTimeOffset;
+
+	int32 ComboNode;
+	uint16 InputSequence;
+
+	UPROPERTY(Replicated, Transient)
+	uint16 LastInputSequence;
+
+	UPROPERTY(ReplicatedUsing = OnRep_EquippedKey, Transient)
+	uint8 EquippedKey;
+
+	UPROPERTY(Replicated, Transient)
 	uint8 WeaponIndex;
-	uint8 SkillIndex;
 
 	UPROPERTY(Replicated, Transient)
 	uint8 bNowCombo : 1;
 
+	uint8 bPredictedCombo : 1;
+	uint8 bIsConsumingInput : 1;
+
 	UPROPERTY(Transient, EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true))
 	uint8 bBlockSkill : 1;
 };
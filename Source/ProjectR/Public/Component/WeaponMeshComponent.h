@@ -19,10 +19,10 @@ public:
 
 	void Detach();
 
-private:
-	void TickComponent(float DeltaTime, ELevelTick TickType,
-		FActorComponentTickFunction* ThisTickFunction) override;
+	// Advances the swap effect and returns whether it is still running.
+	bool TickSwap(float DeltaTime);
 
+private:
 	void SetMesh(USkeletalMesh* Mesh, TSubclassOf<UAnimInstance> Anim,
 		const FVector& Loc, const FQuat& Rot);
 
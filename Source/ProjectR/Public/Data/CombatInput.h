@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CombatInput.generated.h"
+
+UENUM()
+enum class ECombatInputType : uint8
+{
+	WeakAttack, StrongAttack, Dodge, Swap,
+};
+
+USTRUCT()
+struct FCombatInput
+{
+	GENERATED_BODY()
+
+	FORCEINLINE bool IsNewerThan(uint16 OtherSequence) const noexcept
+	{
+		return static_cast<int16>(Sequence - OtherSequence) > 0;
+	}
+
+	// Client world time when the button was pressed.
+	UPROPERTY()
+	float Timestamp;
+
+	UPROPERTY()
+	uint16 Sequence;
+
+	UPROPERTY()
+	ECombatInputType Type;
+
+	// Weapon index of a swap input.
+	UPROPERTY()
+	uint8 Index;
+
+	UPROPERTY()
+	bool bIsPredicted;
+};
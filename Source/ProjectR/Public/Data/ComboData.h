@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ComboData.generated.h"
+
+USTRUCT(BlueprintType)
+struct FComboNode
+{
+	GENERATED_BODY()
+
+	// Uses the weapon's AttackClass when empty.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<class USkill> SkillClass;
+
+	// Selects the DT_SkillData row of this node together with SkillIndex.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bIsOverrided = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 SkillIndex = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Weak = INDEX_NONE;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Strong = INDEX_NONE;
+};
+
+UCLASS(BlueprintType)
+class PROJECTR_API UComboData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TArray<FComboNode> Nodes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 WeakRoot = INDEX_NONE;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 StrongRoot = INDEX_NONE;
+};
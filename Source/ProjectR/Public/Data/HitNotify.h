@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HitNotify.generated.h"
+
+// Damage one character dealt to another during a frame, as sent to clients.
+USTRUCT()
+struct FHitNotify
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	class APRCharacter* Target;
+
+	UPROPERTY()
+	APRCharacter* Causer;
+
+	UPROPERTY()
+	uint16 Damage;
+};
@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MovementLOD.generated.h"
+
+UENUM(BlueprintType)
+enum class EMovementLOD : uint8
+{
+	Full,		// Every frame, with floor sweeps and pawn collision.
+	Reduced,	// Lower frequency, projected onto the navmesh.
+	Minimal,	// Rarely ticked navmesh walking without sweeps or pawn collision.
+};
@@ -23,6 +23,10 @@ struct FWeaponData : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TMap<uint8, TSubclassOf<USkill>> Skills;
 
+	// Replaces ComboHeight and Skills when set.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	class UComboData* Combo;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TAssetPtr<class USkeletalMesh> RightMesh;
 
@@ -55,8 +55,7 @@ private:
 	void PostInitializeComponents() override;
 
 	void BeginPlay() override;
-	
-	void Tick(float DeltaSeconds) override;
+	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
 	float TakeDamage(float Damage, const FDamageEvent& DamageEvent,
 		AController* EventInstigator, AActor* DamageCauser) override;
@@ -75,9 +74,6 @@ private:
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerUnlock();
 
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastOnHit(float Damage, APRCharacter* Causer);
-
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastDeath();
 
@@ -87,12 +83,19 @@ private:
 	void ServerUnlock_Implementation();
 	FORCEINLINE bool ServerUnlock_Validate() const noexcept { return true; }
 
-	void MulticastOnHit_Implementation(float Damage, APRCharacter* Causer);
 	void MulticastDeath_Implementation();
 
+	void PredictLock(bool bIsLock);
+
 	UFUNCTION()
 	void OnRep_IsLocked();
 
+	UFUNCTION()
+	void OnRep_LockedTarget();
+
+	// Hands the current lock to the lock-on subsystem and the movement component.
+	void UpdateLock();
+
 	void ApplyCharacterData(const struct FCharacterData& Data);
 	
 public:
@@ -106,9 +109,6 @@ public:
 	FOnDamaged OnDamaged;
 
 private:
-	UPROPERTY()
-	class UDataTable* CharacterDataTable;
-
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	UWeaponComponent* WeaponComp;
 
@@ -118,7 +118,7 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	UWeaponMeshComponent* LeftWeapon;
 
-	UPROPERTY(Transient, Replicated, BlueprintReadOnly, Category = Lock, meta = (AllowPrivateAccess = true))
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_LockedTarget, BlueprintReadOnly, Category = Lock, meta = (AllowPrivateAccess = true))
 	AActor* LockedTarget;
 
 	UPROPERTY(ReplicatedUsing = OnRep_Health, Transient, VisibleInstanceOnly, BlueprintReadOnly, Category = Data, meta = (AllowPrivateAccess = true))
@@ -138,4 +138,6 @@ private:
 
 	UPROPERTY(Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	uint8 bIsDeath : 1;
+
+	TSharedPtr<struct FStreamableHandle> LoadHandle;
 };
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "GenericTeamAgentInterface.h"
+#include "Data/HitNotify.h"
 #include "PRPlayerController.generated.h"
 
 UCLASS(BlueprintType)
@@ -24,13 +25,18 @@ public:
 	FGenericTeamId GetGenericTeamId() const override;
 	void SetGenericTeamId(const FGenericTeamId& NewTeamId) override;
 
+	// Locks on the best target other than LostTarget, or unlocks when there is none.
+	void Relock(AActor* LostTarget = nullptr);
+
+	// Hits relevant to this player, sent once per frame by the damage subsystem.
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveHits(const TArray<FHitNotify>& Hits);
+
 protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnSetInteractor(UObject* NewInteractor);
 
 private:
-	void BeginPlay() override;
-	void Tick(float DeltaSeconds) override;
 	void SetupInputComponent() override;
 
 	void MoveForward(float Value);
@@ -53,19 +59,17 @@ private:
 
 	void Lock();
 	void Unlock();
-	void Relock();
 
 	void Interact();
 
 	FVector GetDirectionVector(EAxis::Type Axis) const;
 
+	void ClientReceiveHits_Implementation(const TArray<FHitNotify>& Hits);
+
 private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	class UTargetComponent* Targeter;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
-	class UAIPerceptionComponent* Perception;
-
 	UPROPERTY(Transient)
 	UObject* Interactor;
 };
@@ -13,17 +13,26 @@ class PROJECTR_API UPRStatics final : public UBlueprintFunctionLibrary
 	GENERATED_BODY()
 
 public:
-	template <class T, class Func>
-	static void AsyncLoad(const TAssetPtr<T>& SoftPtr, Func&& Fn)
+	// Loads every path in one request and calls Fn once when all of them are resident.
+	// Fn is skipped if Owner is destroyed first. Cancelling the returned handle stops the load.
+	template <class Func>
+	static TSharedPtr<FStreamableHandle> AsyncLoadMany(const UObject* Owner, TArray<FSoftObjectPath> Paths,
+		Func&& Fn, TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
 	{
-		if (SoftPtr.IsNull())
-			return;
-
-		if (SoftPtr.IsPending())
+		Paths.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull() || Path.ResolveObject(); });
+		if (Paths.Num() == 0)
 		{
-			auto Callback = FStreamableDelegate::CreateLambda(Forward<Func>(Fn));
-			UAssetManager::GetStreamableManager().RequestAsyncLoad(SoftPtr.ToSoftObjectPath(), MoveTemp(Callback));
+			Fn();
+			return nullptr;
 		}
-		else Fn();
+
+		TWeakObjectPtr<const UObject> WeakOwner{ Owner };
+		auto Callback = FStreamableDelegate::CreateLambda([WeakOwner, Fn = Forward<Func>(Fn)]() mutable
+		{
+			if (WeakOwner.IsValid())
+				Fn();
+		});
+
+		return UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Paths), MoveTemp(Callback), Priority);
 	}
 };
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Uniform 2D grid rebuilt from scratch, where the items of one cell are contiguous.
+class PROJECTR_API FCombatGrid
+{
+public:
+	explicit FCombatGrid(float InCellSize = 500.0f);
+
+	// Sorts the points by cell. GetOrder maps each sorted slot back to its point.
+	void Build(const TArray<FVector2D>& Points);
+
+	// Calls Fn(Begin, End) with the sorted slot range of every occupied cell touching Box.
+	template <class Func>
+	void Query(const FBox2D& Box, Func&& Fn) const
+	{
+		const FIntPoint Min = GetCell(Box.Min);
+		const FIntPoint Max = GetCell(Box.Max);
+
+		for (int32 CellY = Min.Y; CellY <= Max.Y; ++CellY)
+			for (int32 CellX = Min.X; CellX <= Max.X; ++CellX)
+				if (const auto* Range = Cells.Find(FIntPoint{ CellX, CellY }))
+					Fn(Range->Key, Range->Value);
+	}
+
+	FORCEINLINE const TArray<int32>& GetOrder() const noexcept { return Order; }
+	FORCEINLINE float GetCellSize() const noexcept { return CellSize; }
+
+private:
+	FORCEINLINE FIntPoint GetCell(const FVector2D& Point) const noexcept
+	{
+		return FIntPoint{ FMath::FloorToInt(Point.X / CellSize), FMath::FloorToInt(Point.Y / CellSize) };
+	}
+
+private:
+	TMap<FIntPoint, TPair<int32, int32>> Cells;
+	TArray<int32> Order;
+	float CellSize;
+};
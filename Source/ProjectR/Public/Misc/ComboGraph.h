@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ComboData.h"
+#include "ComboGraph.generated.h"
+
+// Flat combo graph with precomputed transitions. Node 0 is always the dodge.
+USTRUCT()
+struct FComboGraph
+{
+	GENERATED_BODY()
+
+public:
+	void Build(const struct FWeaponData& Data);
+
+	FORCEINLINE int32 GetNext(int32 Node, bool bIsStrong) const noexcept
+	{
+		if (Node == INDEX_NONE) return bIsStrong ? StrongRoot : WeakRoot;
+		if (!Nodes.IsValidIndex(Node)) return INDEX_NONE;
+		return bIsStrong ? Nodes[Node].Strong : Nodes[Node].Weak;
+	}
+
+	FORCEINLINE const TArray<FComboNode>& GetNodes() const noexcept { return Nodes; }
+
+public:
+	static constexpr int32 DodgeNode = 0;
+
+private:
+	void BuildFromTree(const FWeaponData& Data);
+	void BuildFromAsset(const FWeaponData& Data, const UComboData& Combo);
+
+private:
+	UPROPERTY()
+	TArray<FComboNode> Nodes;
+
+	UPROPERTY()
+	int32 WeakRoot = INDEX_NONE;
+
+	UPROPERTY()
+	int32 StrongRoot = INDEX_NONE;
+};
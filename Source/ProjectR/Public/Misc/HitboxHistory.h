@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Ring buffer of past capsule centers, quantized against an anchor to 10 bytes per sample.
+// The anchor follows the character, so only samples out of range of the newest one are ever dropped.
+class PROJECTR_API FHitboxHistory
+{
+public:
+	void Reset(int32 InCapacity);
+	void Record(float Time, const FVector& Location);
+
+	// Interpolates the center at Time, clamped to the oldest sample. Returns false when empty.
+	bool Sample(float Time, FVector& OutLocation) const;
+
+	FORCEINLINE int32 GetAllocatedSize() const noexcept
+		{ return Times.GetAllocatedSize() + QX.GetAllocatedSize() + QY.GetAllocatedSize() + QZ.GetAllocatedSize(); }
+
+public:
+	static constexpr int32 SampleSize = sizeof(float) + sizeof(int16) * 3;
+
+private:
+	// Moves the anchor next to Location by whole steps and converts the kept samples exactly.
+	void Rebase(const FVector& Location);
+
+	FORCEINLINE FVector Dequantize(int32 Idx) const noexcept
+		{ return Anchor + FVector(QX[Idx], QY[Idx], QZ[Idx]) * Step; }
+
+	FORCEINLINE int32 GetSlot(int32 Age) const noexcept
+		{ return (Head - Age + Capacity) % Capacity; }
+
+private:
+	TArray<float> Times;
+	TArray<int16> QX;
+	TArray<int16> QY;
+	TArray<int16> QZ;
+
+	FVector Anchor;
+	int32 Capacity = 0;
+	int32 Head = 0;
+	int32 Num = 0;
+
+	// Quantization step in world units, giving a range of about 80 m around the anchor.
+	static constexpr float Step = 0.25f;
+};
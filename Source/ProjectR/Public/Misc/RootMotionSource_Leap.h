@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/RootMotionSource.h"
+#include "Misc/Spline.h"
+#include "RootMotionSource_Leap.generated.h"
+
+// Moves the character along a two segment spline, spending FirstRatio of the duration on the first one.
+// The points are sent once when the leap starts; root motion updates carry only a key of the quantized points,
+// which also decides whether the owner's source matches the server's.
+USTRUCT()
+struct PROJECTR_API FRootMotionSource_Leap : public FRootMotionSource
+{
+	GENERATED_BODY()
+
+public:
+	FRootMotionSource_Leap();
+
+	void SetPath(const TArray<FVector>& InPoints, float InFirstRatio);
+	FVector GetPathLocation(float Time) const;
+
+	// Points rounded to the precision they are sent with, so a path received from the server keys the same.
+	static uint32 MakePathKey(const TArray<FVector>& InPoints);
+
+	FRootMotionSource* Clone() const override;
+	bool Matches(const FRootMotionSource* Other) const override;
+
+	void PrepareRootMotion(float SimulationTime, float MovementTickTime,
+		const ACharacter& Character, const UCharacterMovementComponent& MoveComponent) override;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+	UScriptStruct* GetScriptStruct() const override;
+	FString ToSimpleString() const override;
+
+public:
+	UPROPERTY()
+	TArray<FVector> Points;
+
+	UPROPERTY()
+	float FirstRatio;
+
+	UPROPERTY()
+	uint32 PathKey;
+
+private:
+	FSplineCurve Curve;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRootMotionSource_Leap> : public TStructOpsTypeTraitsBase2<FRootMotionSource_Leap>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true
+	};
+};
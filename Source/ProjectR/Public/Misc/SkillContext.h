@@ -27,10 +27,23 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void StopAnimation(UAnimMontage* Animation);
 
+	// Sweeps every enabled attack component along its path since the last frame.
+	void TickHit();
+
 private:
-	UFUNCTION()
-	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	struct FHitTrace
+	{
+		FVector LocalStart;
+		FVector LocalEnd;
+		FVector LastStart;
+		FVector LastEnd;
+		float Radius;
+		bool bHasLast;
+	};
+
+	void BeginTrace(int32 Idx);
+	void GetTraceSegment(int32 Idx, FVector& OutStart, FVector& OutEnd) const;
+	void SweepTrace(int32 Idx, TArray<AActor*>& OutActors);
 
 	UFUNCTION()
 	void OnMontageEnded(UAnimMontage* Montage, bool bInterrupted);
@@ -44,6 +57,8 @@ private:
 	void MulticastPlayAnimation_Implementation(UAnimMontage* Animation);
 	void MulticastStopAnimation_Implementation(UAnimMontage* Animation);
 
+	bool IsPredictedAnimation(UAnimMontage* Animation) const;
+
 public:
 	UPROPERTY(BlueprintAssignable)
 	FOnHit OnHit;
@@ -54,4 +69,10 @@ private:
 
 	UPROPERTY(Transient)
 	TMap<UAnimMontage*, FOnAnimationEnded> Callbacks;
+
+	TArray<FHitTrace> Traces;
+	int32 EnabledPart;
+
+	// Upper bound of interpolated poses swept per component and frame.
+	static constexpr int32 MaxSubstep = 8;
 };
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Skill montages the owning client played ahead of the server, in input order.
+class PROJECTR_API FSkillPredictionQueue
+{
+public:
+	// Makes Montage the current prediction, replacing any earlier one.
+	void Add(class UAnimMontage* Montage, uint16 Sequence);
+
+	// Drops an accepted entry, or a rejected one together with every later entry built on it.
+	// Montages to stop are returned in OutRolledBack. Returns false when Sequence is not pending.
+	bool Confirm(uint16 Sequence, bool bIsAccepted, TArray<UAnimMontage*>& OutRolledBack);
+
+	// Releases the current prediction when its montage ends, however it ended.
+	// Returns false when a newer prediction or a rollback already replaced it.
+	bool End(const UAnimMontage* Montage, uint16 Sequence);
+
+	bool Contains(const UAnimMontage* Montage) const noexcept;
+
+	FORCEINLINE bool IsActive() const noexcept { return CurrentMontage != nullptr; }
+	FORCEINLINE int32 GetPendingNum() const noexcept { return Pending.Num(); }
+
+private:
+	struct FEntry
+	{
+		UAnimMontage* Montage;
+		uint16 Sequence;
+	};
+
+	TArray<FEntry> Pending;
+	UAnimMontage* CurrentMontage = nullptr;
+	uint16 CurrentSequence = 0u;
+};
@@ -6,21 +6,85 @@
 #include "UObject/NoExportTypes.h"
 #include "Spline.generated.h"
 
+// Catmull-Rom curve through a set of points, where segment Idx runs from Points[Idx] to Points[Idx + 1].
+// Segments are cached with an arc-length table for constant speed traversal.
+struct PROJECTR_API FSplineCurve
+{
+public:
+	void Build(const TArray<FVector>& Points, float Parameterization);
+
+	// Alpha is a fraction of the segment's arc length.
+	bool ComputeUniform(int32 Idx, float Alpha, FVector& Point) const;
+	bool ComputeAtDistance(float Distance, FVector& Point) const;
+
+	// Evaluates many distances along the curve, four samples per register.
+	// Ascending distances, such as a whole path sampled at once, skip the arc-length search.
+	void ComputeBatch(TArrayView<const float> InDistances, TArrayView<FVector> OutPoints) const;
+
+	// Evaluates segment Idx of Points at parameter Alpha without building a curve.
+	static FVector Compute(const TArray<FVector>& Points, int32 Idx, float Alpha, float Parameterization);
+
+	FORCEINLINE float GetLength() const noexcept { return Distances.Num() > 0 ? Distances.Last() : 0.0f; }
+	FORCEINLINE bool IsBuilt() const noexcept { return Segments.Num() > 0; }
+
+public:
+	// Arc-length samples per segment.
+	static constexpr int32 Resolution = 16;
+
+private:
+	// Cubic of one segment, P(T) = ((A * T + B) * T + C) * T + D.
+	struct FSegment
+	{
+		FVector4 A, B, C, D;
+	};
+
+	// InOutUpper is the arc-length slot found for the previous distance, or 0 when there is none.
+	void FindParameter(float Distance, int32& OutSegment, float& OutT, int32& InOutUpper) const;
+
+	static FSegment MakeSegment(const TArray<FVector>& Points, int32 Idx, float Parameterization);
+	static FVector Evaluate(const FSegment& Segment, float T);
+
+private:
+	TArray<FSegment> Segments;
+
+	// Cumulative arc length at every sample, starting at Points[1].
+	TArray<float> Distances;
+};
+
 UCLASS(BlueprintType)
 class PROJECTR_API USpline : public UObject
 {
 	GENERATED_BODY()
 
 public:
+	USpline();
+
 	UFUNCTION(BlueprintCallable)
 	bool Compute(int32 Idx, float Alpha, FVector& Point);
 
 	UFUNCTION(BlueprintCallable)
 	bool IsValidIndex(int32 Idx);
 
+	UFUNCTION(BlueprintCallable)
+	void Build();
+
+	// Like Compute, but Alpha is a fraction of the segment's arc length. Needs Build().
+	UFUNCTION(BlueprintCallable)
+	bool ComputeUniform(int32 Idx, float Alpha, FVector& Point) const;
+
+	UFUNCTION(BlueprintCallable)
+	bool ComputeAtDistance(float Distance, FVector& Point) const;
+
+	FORCEINLINE const FSplineCurve& GetCurve() const noexcept { return Curve; }
 	FORCEINLINE TArray<FVector>& GetPoints() noexcept { return Points; }
 
 private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true))
 	TArray<FVector> Points;
+
+	// 0 is uniform, 0.5 centripetal and 1 chordal. Centripetal never cusps or self-intersects.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true, ClampMin = 0.0, ClampMax = 1.0))
+	float Parameterization;
+
+	FSplineCurve Curve;
 };
@@ -5,73 +5,64 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Data/VisualData.h"
+#include "Misc/ComboGraph.h"
 #include "Weapon.generated.h"
 
 DECLARE_DELEGATE(FOnAsyncLoadEndedSingle);
 DECLARE_MULTICAST_DELEGATE(FOnAsyncLoadEnded);
 
 USTRUCT()
-struct FUsableSkill
+struct FWeaponState
 {
 	GENERATED_BODY()
 
-	UPROPERTY()
-	class USkill* Skill;
-
-	UPROPERTY()
-	class UDataAsset* Data;
+	UPROPERTY(Transient)
+	class UWeapon* Weapon;
 
-	uint8 bIsOverrided : 1;
+	const TArray<class UDataAsset*>* SkillData;
 };
 
+// Immutable weapon archetype shared by every user of the same key.
 UCLASS(BlueprintType)
 class PROJECTR_API UWeapon final : public UObject
 {
 	GENERATED_BODY()
 	
 public:
-	UWeapon();
-	bool Initialize(class USkillContext* InContext, uint8 InKey);
-	void InitSkill(uint8 Level);
-
-	void BeginSkill(uint8 Index);
-	void EndSkill(uint8 Index);
+	void Initialize(uint8 InKey, const struct FWeaponData& Data, const FComboGraph& Graph);
 
-	void TickSkill(uint8 Index, float DeltaTime);
-	
 	void RegisterOnAsyncLoadEnded(const FOnAsyncLoadEndedSingle& Callback);
 
-	void Execute(uint8 Index);
-	void BeginExecute(uint8 Index);
-	void EndExecute(uint8 Index);
+	void Load(const FWeaponData& Data);
+
+	// Drops the loaded meshes and blend spaces so they can be garbage collected.
+	void Unload();
+
+	FORCEINLINE UClass* GetSkillClass(int32 Node) const noexcept
+		{ return ComboGraph.GetNodes().IsValidIndex(Node) ? *ComboGraph.GetNodes()[Node].SkillClass : nullptr; }
 
+	FORCEINLINE int32 GetNextNode(int32 Node, bool bIsStrong) const noexcept
+		{ return ComboGraph.GetNext(Node, bIsStrong); }
 	FORCEINLINE const FVisualData& GetVisualData() const noexcept { return VisualData; }
 	FORCEINLINE uint8 GetKey() const noexcept { return Key; }
+	FORCEINLINE bool IsLoadRequested() const noexcept { return bIsLoadRequested; }
 
 private:
-	void LoadAll(const struct FWeaponData& WeaponData);
+	void BroadcastAsyncLoadEnded();
 
-private:
-	UPROPERTY(Transient)
-	class APRCharacter* User;
-	
-	UPROPERTY(Transient)
-	TArray<FUsableSkill> Skills;
+	void BeginDestroy() override;
 
-	UPROPERTY(Transient)
-	USkillContext* Context;
+private:
+	UPROPERTY()
+	FComboGraph ComboGraph;
 
 	UPROPERTY(Transient)
 	FVisualData VisualData;
 
-	UPROPERTY()
-	class UDataTable* WeaponDataTable;
-
-	UPROPERTY()
-	UDataTable* SkillDataTable;
-
 	FOnAsyncLoadEnded OnAsyncLoadEnded;
+	TSharedPtr<struct FStreamableHandle> LoadHandle;
 
 	uint8 Key;
-	uint8 AsyncLoadCount;
+	uint8 bIsLoaded : 1;
+	uint8 bIsLoadRequested : 1;
 };
@@ -11,37 +11,15 @@ class PROJECTR_API ULeap final : public USingleAttack
 {
 	GENERATED_BODY()
 
-public:
-	ULeap();
-
 private:
-	void Initialize() override;
 	void Begin(USkillContext* InContext, const UDataAsset* Data) override;
-	void Tick(float DeltaTime) override;
 	void End() override;
 
-	void SetData(const UDataAsset* Data);
-	void InitSpline();
-	void UpdateSpline();
-	void UpdateLeap(float DeltaTime);
-
-private:
-	UPROPERTY()
-	class USpline* Spline;
-
-	UPROPERTY(Transient)
-	class AActor* Target;
-
-	FVector StartLocation;
-
-	float RootHeight;
-	float MaxHeight;
-	float LeapDuration;
-	float AttackRange;
-	float MaxHeightRatio;
-	float LeapTimeRatio;
+	void BeginPrediction(APRCharacter* InUser, const UDataAsset* Data) const override;
+	void EndPrediction(APRCharacter* InUser) const override;
 
-	int32 Idx;
-	float Alpha;
-	uint8 bIsLeapEnded : 1;
+	// The server and the owner both start the root motion source, so the movement component can pair them.
+	static void StartLeap(APRCharacter* InUser, const UDataAsset* Data);
+	static void StopLeap(APRCharacter* InUser);
+	static void BuildPath(const APRCharacter* InUser, const class ULeapData& Data, TArray<FVector>& OutPoints);
 };
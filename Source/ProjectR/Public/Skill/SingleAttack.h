@@ -17,6 +17,7 @@ protected:
 	void End() override;
 
 	bool CanUseSkill_Implementation() const override;
+	UAnimMontage* GetPredictedAnimation(const APRCharacter* InUser, const UDataAsset* Data) const override;
 
 	void BeginExecute_Implementation() override;
 	void EndExecute_Implementation() override;
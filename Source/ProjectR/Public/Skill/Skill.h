@@ -20,8 +20,17 @@ public:
 	UFUNCTION(BlueprintNativeEvent)
 	bool CanUseSkill() const;
 
+	// Called on the class default object so the owning client can play the montage before the server confirms.
+	virtual class UAnimMontage* GetPredictedAnimation(const class APRCharacter* InUser, const UDataAsset* Data) const;
+
+	// Mirror Begin and End on the owning client for the movement a predicted skill drives itself.
+	virtual void BeginPrediction(APRCharacter* InUser, const UDataAsset* Data) const {}
+	virtual void EndPrediction(APRCharacter* InUser) const {}
+
 	UWorld* GetWorld() const override;
 
+	FORCEINLINE bool IsTickable() const noexcept { return bCanEverTick; }
+
 protected:
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "Initialize"))
 	void ReceiveInitialize();
@@ -42,6 +51,10 @@ protected:
 
 	FORCEINLINE class APRCharacter* GetUser() const noexcept { return User; }
 
+protected:
+	// Skills that never tick are not registered with the combat tick subsystem.
+	uint8 bCanEverTick : 1;
+
 private:
 	UPROPERTY(Transient, BlueprintReadOnly, Category = Owner, meta = (AllowPrivateAccess = true))
 	APRCharacter* User;
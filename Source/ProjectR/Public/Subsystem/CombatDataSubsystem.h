@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Misc/ComboGraph.h"
+#include "CombatDataSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct FCombatDataReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FName> MissingRows;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FName> InvalidRows;
+};
+
+UCLASS()
+class PROJECTR_API UCombatDataSubsystem final : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCombatDataSubsystem();
+
+	static UCombatDataSubsystem* Get(const UObject* WorldContextObject);
+
+	const struct FCharacterData* FindCharacterData(uint8 Key) const;
+	const struct FWeaponData* FindWeaponData(uint8 Key) const;
+	class UDataAsset* FindSkillData(uint8 WeaponKey, uint8 Level, bool bIsOverrided, int32 SkillIdx) const;
+
+	const TArray<UDataAsset*>* ResolveSkills(uint8 WeaponKey, uint8 Level);
+
+	class UWeapon* GetWeapon(uint8 Key);
+
+	// Keeps the loadout of a remote actor resident on this client while it is among the nearest ones.
+	void RegisterLoadout(const AActor* Owner, const TArray<uint8>& Keies, uint8 EquippedKey);
+	void UnregisterLoadout(const AActor* Owner);
+
+	FORCEINLINE const FCombatDataReport& GetReport() const noexcept { return Report; }
+
+public:
+	static constexpr uint8 MaxLevel = 10u;
+
+	// Reserved so replicated keys can start out different from every real weapon, including the unarmed key 0.
+	static constexpr uint8 InvalidKey = MAX_uint8;
+
+	// Number of weapon archetypes a client keeps loaded for prefetched loadouts.
+	static constexpr int32 PrefetchBudget = 24;
+	static constexpr float PrefetchInterval = 1.0f;
+
+private:
+	struct FWeaponEntry
+	{
+		const FWeaponData* Data = nullptr;
+		FComboGraph Graph;
+		int32 CommonSlotNum = 0;
+		int32 SlotNum = 0;
+		TArray<UDataAsset*> SkillData;
+		TArray<TArray<UDataAsset*>> ResolvedSkills;
+	};
+
+	struct FLoadout
+	{
+		TWeakObjectPtr<const AActor> Owner;
+		TArray<uint8> Keies;
+		uint8 EquippedKey;
+	};
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	void Load();
+	void LoadCharacterData();
+	void LoadWeaponData();
+	void LoadSkillData(uint8 WeaponKey, FWeaponEntry& Entry);
+
+	bool ParseKey(FName RowName, uint8& OutKey);
+
+	// Loads the loadouts nearest to the local view and evicts the rest beyond the budget.
+	void UpdatePrefetch();
+
+private:
+	UPROPERTY()
+	class UDataTable* CharacterDataTable;
+
+	UPROPERTY()
+	UDataTable* WeaponDataTable;
+
+	UPROPERTY()
+	UDataTable* SkillDataTable;
+
+	UPROPERTY(Transient)
+	TArray<UWeapon*> WeaponArchetypes;
+
+	UPROPERTY(Transient, VisibleInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	FCombatDataReport Report;
+
+	TArray<const FCharacterData*> Characters;
+	TArray<FWeaponEntry> Weapons;
+	TArray<FLoadout> Loadouts;
+
+	FTimerHandle PrefetchTimer;
+
+	uint8 bIsLoaded : 1;
+};
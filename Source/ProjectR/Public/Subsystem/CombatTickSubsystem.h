@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "CombatTickSubsystem.generated.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat"), STATGROUP_Combat, STATCAT_Advanced);
+
+DECLARE_DELEGATE_OneParam(FOnCombatQuery, const TArray<FHitResult>&);
+
+UCLASS()
+class PROJECTR_API UCombatTickSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UCombatTickSubsystem* Get(const UObject* WorldContextObject);
+
+	void RegisterSkill(class USkill* Skill);
+	void UnregisterSkill(USkill* Skill);
+
+	void RegisterSwap(class UWeaponMeshComponent* Mesh);
+
+	void RegisterContext(class USkillContext* Context);
+	void UnregisterContext(USkillContext* Context);
+
+	// Queries run on the physics async trace buffer; callbacks fire together on the next frame.
+	void AsyncLineTrace(const FVector& Start, const FVector& End,
+		const FCollisionObjectQueryParams& ObjectParams, const FOnCombatQuery& Callback);
+
+private:
+	struct FPendingQuery
+	{
+		FTraceHandle Handle;
+		FOnCombatQuery Callback;
+	};
+
+	void ConsumeQueries();
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override;
+	TStatId GetStatId() const override;
+
+private:
+	UPROPERTY(Transient)
+	TArray<USkill*> Skills;
+
+	UPROPERTY(Transient)
+	TArray<UWeaponMeshComponent*> Swaps;
+
+	UPROPERTY(Transient)
+	TArray<USkillContext*> Contexts;
+
+	TArray<FPendingQuery> PendingQueries;
+
+	uint8 bIsTicking : 1;
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Data/HitNotify.h"
+#include "DamageSubsystem.generated.h"
+
+// Collects the damage of a frame and resolves it in one pass, so a hit on many targets
+// costs one hit batch per connection and one perception update.
+UCLASS()
+class PROJECTR_API UDamageSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UDamageSubsystem* Get(const UObject* WorldContextObject);
+
+	void QueueDamage(AActor* Target, float Damage, class AController* Instigator, AActor* Causer);
+
+	// Records damage a character has taken so it is notified with the rest of the frame.
+	void AddHit(class APRCharacter* Target, float Damage, APRCharacter* Causer);
+
+private:
+	struct FPendingDamage
+	{
+		TWeakObjectPtr<AActor> Target;
+		TWeakObjectPtr<AController> Instigator;
+		TWeakObjectPtr<AActor> Causer;
+		float Damage;
+	};
+
+	void ApplyDamages();
+	void SendHits();
+	void ReportHits();
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override;
+	TStatId GetStatId() const override;
+
+private:
+	TArray<FPendingDamage> PendingDamages;
+
+	UPROPERTY(Transient)
+	TArray<FHitNotify> Hits;
+};
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GroundSubsystem.generated.h"
+
+// Answers where the static ground is below actors and locations from caches refreshed by async traces,
+// so skills and AI can ask every frame without tracing every frame.
+UCLASS()
+class PROJECTR_API UGroundSubsystem final : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UGroundSubsystem* Get(const UObject* WorldContextObject);
+
+	// Cached ground below Target, traced again once it moved further than MoveThreshold.
+	// Falls back to the heightfield until the first trace of a target returns.
+	bool GetGroundHeight(const AActor* Target, float& OutHeight);
+
+	// Coarse heightfield lookup of the highest floor not above Location; a missing cell is sampled in the background.
+	bool GetCellHeight(const FVector& Location, float& OutHeight);
+
+	// Samples every floor of every cell within the box right away, e.g. when an arena is entered.
+	UFUNCTION(BlueprintCallable)
+	void BakeHeightfield(const FVector& Center, const FVector& Extent);
+
+public:
+	static constexpr float MoveThreshold = 50.0f;
+	static constexpr float CellSize = 200.0f;
+	static constexpr float TraceDepth = 2000.0f;
+
+	// Floors of a cell closer than FloorGap are merged, and a cell keeps at most MaxFloors of them.
+	static constexpr float FloorGap = 100.0f;
+	static constexpr int32 MaxFloors = 4;
+
+private:
+	struct FGroundEntry
+	{
+		FVector2D SampledAt;
+		float Height;
+		uint8 bIsValid : 1;
+		uint8 bIsPending : 1;
+	};
+
+	void TraceTarget(const AActor* Target, FGroundEntry& Entry);
+	void OnTargetTraced(const TArray<FHitResult>& Hits, TWeakObjectPtr<const AActor> Target);
+	void OnCellTraced(const TArray<FHitResult>& Hits, FIntPoint Cell);
+	void AddFloor(const FIntPoint& Cell, float Height);
+
+	FORCEINLINE static FIntPoint ToCell(const FVector& Location) noexcept
+	{
+		return FIntPoint{ FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize) };
+	}
+
+private:
+	TMap<TWeakObjectPtr<const AActor>, FGroundEntry> Entries;
+	// Heights of every floor found in a cell in ascending order, so overlapping floors keep their own ground.
+	TMap<FIntPoint, TArray<float, TInlineAllocator<MaxFloors>>> Cells;
+	TSet<FIntPoint> PendingCells;
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GenericTeamAgentInterface.h"
+#include "Tickable.h"
+#include "Misc/CombatGrid.h"
+#include "Misc/HitboxHistory.h"
+#include "HitboxSubsystem.generated.h"
+
+// Combat broadphase over the hit capsules of every registered character, built once per frame on demand.
+// It also records their recent positions so hits of remote players can be validated where they aimed.
+UCLASS(Config = Game)
+class PROJECTR_API UHitboxSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UHitboxSubsystem();
+
+	static UHitboxSubsystem* Get(const UObject* WorldContextObject);
+
+	void Register(class APRCharacter* Character);
+	void Unregister(APRCharacter* Character);
+
+	// Adds every character of another team whose hit capsule overlaps the capsule from Start to End,
+	// with targets moved back to where they were RewindTime seconds ago.
+	void OverlapCapsule(const FVector& Start, const FVector& End, float Radius, FGenericTeamId TeamId,
+		const AActor* IgnoredActor, TArray<AActor*>& OutActors, float RewindTime = 0.0f);
+
+	// How far back the attacker saw the world, which is zero for local and AI controlled pawns.
+	float GetRewindTime(const class APawn* Attacker) const;
+
+	// Tests four upright capsules at once and returns a lane bit for every overlap.
+	// Every input array must hold four readable floats.
+	static int32 OverlapLanes(const float* InX, const float* InY, const float* InBottom, const float* InTop,
+		const float* InRadii, const FVector& Start, const FVector& Dir, float Radius);
+
+private:
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override;
+	TStatId GetStatId() const override;
+
+	void BuildIfNeeded();
+
+private:
+	UPROPERTY(Config)
+	float HistoryDepth;
+
+	UPROPERTY(Config)
+	float HistoryRate;
+
+	// Upper bound of history bytes per character, which wins over HistoryDepth when smaller.
+	UPROPERTY(Config)
+	int32 HistoryBudget;
+
+	// Extra broadphase margin for targets that moved since the rewind time.
+	UPROPERTY(Config)
+	float RewindMargin;
+
+	UPROPERTY(Transient)
+	TArray<APRCharacter*> Characters;
+
+	TArray<FHitboxHistory> Histories;
+
+	FCombatGrid Grid;
+
+	// Upright hit capsules in grid order, padded by three lanes for the SIMD loads.
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<float> Bottom;
+	TArray<float> Top;
+	TArray<float> Radii;
+	TArray<uint8> Teams;
+	TArray<int32> Sources;
+	TArray<APRCharacter*> Owners;
+
+	float LastRecordTime;
+	float MaxHitRadius;
+	uint64 BuiltFrame;
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "LockOnSubsystem.generated.h"
+
+// Keeps the active lock-ons of this machine: turns the view of locally controlled lockers
+// and lets the server look for a new target once a locked one dies or leaves sight.
+UCLASS()
+class PROJECTR_API ULockOnSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static ULockOnSubsystem* Get(const UObject* WorldContextObject);
+
+	void Register(class APRCharacter* Owner, AActor* Target);
+	void Unregister(APRCharacter* Owner);
+
+	void NotifyTargetLost(APRCharacter* Owner, AActor* LostTarget);
+
+public:
+	static constexpr float ControlRotationSpeed = 8.0f;
+
+private:
+	struct FLock
+	{
+		TWeakObjectPtr<APRCharacter> Owner;
+		TWeakObjectPtr<AActor> Target;
+	};
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override;
+	TStatId GetStatId() const override;
+
+	void BindTarget(AActor* Target);
+	void ReleaseTarget(AActor* Target);
+
+	UFUNCTION()
+	void OnTargetDeath();
+
+private:
+	TArray<FLock> Locks;
+};
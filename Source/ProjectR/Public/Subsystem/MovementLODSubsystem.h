@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Data/MovementLOD.h"
+#include "MovementLODSubsystem.generated.h"
+
+// Lowers the movement cost of AI characters far from or behind every player.
+UCLASS(Config = Game)
+class PROJECTR_API UMovementLODSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UMovementLODSubsystem();
+
+	static UMovementLODSubsystem* Get(const UObject* WorldContextObject);
+
+	void Register(class APRCharacter* Character);
+	void Unregister(APRCharacter* Character);
+
+private:
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override;
+	TStatId GetStatId() const override;
+
+	void UpdateLODs();
+
+	// Distance to the nearest player, stretched for characters behind that player's view.
+	float GetSignificance(const FVector& Location) const;
+	EMovementLOD SelectLOD(EMovementLOD Current, float Significance) const;
+
+private:
+	struct FViewer
+	{
+		FVector Location;
+		FVector2D Forward;
+	};
+
+	UPROPERTY(Config)
+	float NearDistance;
+
+	UPROPERTY(Config)
+	float FarDistance;
+
+	// Fraction a threshold is widened by before a character falls back to a lower tier.
+	UPROPERTY(Config)
+	float Hysteresis;
+
+	UPROPERTY(Config)
+	float OffscreenScale;
+
+	UPROPERTY(Config)
+	float UpdateInterval;
+
+	UPROPERTY(Transient)
+	TArray<APRCharacter*> Characters;
+
+	TArray<FViewer> Viewers;
+	float ElapsedTime;
+};
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Misc/CombatGrid.h"
+#include "TargetingSubsystem.generated.h"
+
+// Finds the hostile characters in sight of every targeting component in one pass over a shared grid.
+// Line of sight comes from async traces, cached per viewer and refreshed on every update of that viewer.
+UCLASS()
+class PROJECTR_API UTargetingSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UTargetingSubsystem();
+
+	static UTargetingSubsystem* Get(const UObject* WorldContextObject);
+
+	void RegisterCharacter(class APRCharacter* Character);
+	void UnregisterCharacter(APRCharacter* Character);
+
+	void RegisterViewer(class UTargetComponent* Viewer);
+	void UnregisterViewer(UTargetComponent* Viewer);
+
+private:
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override;
+	TStatId GetStatId() const override;
+
+	void BuildGrid();
+	void QueryViewer(const UTargetComponent* Viewer, TArray<AActor*>& OutCandidates) const;
+
+	// Keeps the candidates last traced as visible and traces every candidate again for the next update.
+	void FilterVisible(UTargetComponent* Viewer, TArray<AActor*>& InOutCandidates);
+	void OnSightTraced(const TArray<FHitResult>& Hits, TWeakObjectPtr<UTargetComponent> Viewer, TWeakObjectPtr<AActor> Candidate);
+
+private:
+	UPROPERTY(Transient)
+	TArray<APRCharacter*> Characters;
+
+	UPROPERTY(Transient)
+	TArray<UTargetComponent*> Viewers;
+
+	FCombatGrid Grid;
+
+	// Living characters in grid order.
+	TArray<FVector> Locations;
+	TArray<uint8> Teams;
+	TArray<APRCharacter*> Owners;
+
+	TArray<AActor*> Candidates;
+
+	// Whether each candidate in a viewer's cone was visible when last traced.
+	TMap<TWeakObjectPtr<UTargetComponent>, TMap<TWeakObjectPtr<AActor>, bool>> Sight;
+};